@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "frame_batch.hpp"
+#include "memory_budget.hpp"
+
+// 첽дļĺ
+enum class AsyncWriteBackend {
+    Auto, // Ŀǰͬ ThreadPoolio_uring ڸں liburing 汾֤ǰʽѡ
+    IoUring, // ʵԣio_uring VGGT_WITH_LIBURING 룬Linux 5.19+ʱ˵̳߳
+    ThreadPool, // ͨдɹִ̲߳
+};
+
+// 첽дļ
+struct AsyncWriterOptions {
+    AsyncWriteBackend backend = AsyncWriteBackend::Auto; // 
+    int threads = 4; // ̳߳غ˵Ĺ߳
+    int in_flight = 64; // io_uring ͬʱ;ļÿļ open/write/close 
+    std::size_t max_pending = 256; // ȴдļޣʱ write 
+};
+
+// дһļõ
+struct FileWriteJob {
+    std::filesystem::path path; // Ŀ·Ŀ¼Ѵ
+    std::vector<unsigned char> data; // ļ
+    std::shared_ptr<MemoryReservation> reservation; // ԴεڴԤԤдͷ
+};
+
+// 첽ļд÷ѱõݽ writeд롢رļϵͳ
+// ں̨ɡio_uring ˰Ѷļ open/write/close Žһύ
+// ̲߳ٱļϵͳ
+class AsyncFileWriter {
+public:
+    explicit AsyncFileWriter(const AsyncWriterOptions& options = {});
+    ~AsyncFileWriter();
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    // Ŷд data  pathдļﵽʱclose ֮󷵻 false
+    // reservation ΪԴεԤԤļдǰεԤ黹ݲٵԤ
+    // ߳ԤͬʱͬһԤ룬߳ռԤʱ˫޷ǰ
+    bool write(std::filesystem::path path, std::vector<unsigned char> data,
+               std::shared_ptr<MemoryReservation> reservation = nullptr);
+    // ȴŶӵļȫд֮꣬ٽļ
+    void close();
+
+    const char* backend_name() const noexcept;
+    std::uint64_t files_written() const noexcept { return files_written_.load(); }
+    std::uint64_t bytes_written() const noexcept { return bytes_written_.load(); }
+    std::uint64_t failures() const noexcept { return failures_.load(); }
+
+private:
+    void run_thread_pool();
+#ifdef VGGT_WITH_LIBURING
+    bool start_uring();
+    void run_uring();
+#endif
+    // ͬд̳߳غˣԼ io_uring ʧܺԣ
+    bool write_sync(const FileWriteJob& job);
+    void finish(const FileWriteJob& job, bool ok);
+
+    AsyncWriterOptions options_;
+    BlockingQueue<FileWriteJob> jobs_;
+    std::vector<std::thread> workers_;
+    bool uring_ = false; // ʵʹõ io_uring 
+    struct UringState;
+    std::unique_ptr<UringState> uring_state_;
+    std::atomic<std::uint64_t> files_written_{0};
+    std::atomic<std::uint64_t> bytes_written_{0};
+    std::atomic<std::uint64_t> failures_{0};
+    bool closed_ = false;
+};
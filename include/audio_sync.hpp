@@ -0,0 +1,25 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "frame_extractor.hpp"
+#include "sync_offsets.hpp"
+
+// Ƶͬ
+struct AudioSyncOptions {
+    int sample_rate = 4000; // ʹõĲʣHzƫƷֱ
+    double analysis_seconds = 300.0; // ֻÿ·ͷʱƵ
+    double max_offset_seconds = 30.0; // ƫΧ
+    int reference_cam = -1; // οӽǣ-1 ʾСĿӽ
+};
+
+// һ죬ƽΪ󽵲 options.sample_rate
+// û OpenCV ָ֧ļƵʱ false
+bool decode_audio_track(const std::filesystem::path& path, const AudioSyncOptions& options,
+                        std::vector<float>& samples);
+
+// ÿ·Ƶڸ߳нƵοӽأοӽǵƫΪ 0
+// ޷ƵӽǲڽС
+SyncOffsets estimate_audio_offsets(const std::vector<CameraVideo>& videos,
+                                   const AudioSyncOptions& options);
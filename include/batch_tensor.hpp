@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "frame_batch.hpp"
+
+// ģԤ
+struct TensorOptions {
+    int width = 518; // ȣ<=0 ʾԭʼ
+    int size_multiple = 14; // ߶ȰźȡñVGGT patch С
+};
+
+// ͬתģ[cams, 3, H, W]float32RGBȡֵ [0, 1]
+struct BatchTensor {
+    int frame_index = -1; //֡
+    double timestamp = 0.0; //ʱ
+    std::vector<int> cam_ids; // i ӽǶӦͷID
+    std::vector<std::int64_t> shape; //״
+    std::shared_ptr<std::vector<float>> storage; //洢ݣԻ
+
+    bool is_valid() const noexcept { return storage && !storage->empty(); }
+    float* data() const noexcept { return storage ? storage->data() : nullptr; }
+    std::size_t size() const noexcept { return storage ? storage->size() : 0; }
+};
+
+// أһͷʱصУһֱӸã
+// ÿ·伸ʮ MB ڴ档ͨ std::make_shared 
+class TensorBufferPool : public std::enable_shared_from_this<TensorBufferPool> {
+public:
+    explicit TensorBufferPool(std::size_t max_cached = 4) : max_cached_(max_cached) {}
+
+    std::shared_ptr<std::vector<float>> acquire(std::size_t elements);
+    std::size_t cached() const;
+
+private:
+    void recycle(std::vector<float>* buffer);
+
+    mutable std::mutex mutex_; // б
+    std::vector<std::unique_ptr<std::vector<float>>> free_; // л
+    std::size_t max_cached_; // ໺Ŀл
+};
+
+// һͬ֡תΪģӽŵͬߴ硣
+// pool ǿʱӻڴ档֡ΪջͲ CV_8UC3 ʱЧ
+BatchTensor make_batch_tensor(const FrameBatch& batch, const TensorOptions& options = {},
+                              TensorBufferPool* pool = nullptr);
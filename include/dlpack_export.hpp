@@ -0,0 +1,11 @@
+#pragma once
+
+#include <dlpack/dlpack.h>
+
+#include "batch_tensor.hpp"
+
+// ģΪ DLPackCPUfloat32򣩡
+// ص DLManagedTensor ݵһãѷ torch.from_dlpack
+//  deleter ͷţ TensorBufferPool صиá
+// Чʱ nullptr
+DLManagedTensor* to_dlpack(const BatchTensor& tensor);
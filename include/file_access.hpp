@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// ļҳʾLinux/POSIX·ƵȡʱȡλǰԤһΣ
+// ɰѶĲִҳжתݼ档
+// ʾļҳ棬˶ cv::VideoCapture ڲ򿪵ļͬЧ
+// ƽ̨ open  falseеöǿղ
+class FileAccessHints {
+public:
+    FileAccessHints() = default;
+    FileAccessHints(const FileAccessHints&) = delete;
+    FileAccessHints& operator=(const FileAccessHints&) = delete;
+    ~FileAccessHints();
+
+    // readahead_bytesȡλǰԤֽ0 ʾԤ
+    // drop_behindȡλ֮Ѷҳ
+    bool open(const std::filesystem::path& path, std::size_t readahead_bytes, bool drop_behind);
+    void close();
+
+    // ȡλƽ positionֽڣֻԽԤ/Ĳʱŷϵͳ
+    void advance(std::uint64_t position);
+    //  seek ´ position ʼԤѶķΧˣ
+    void reset(std::uint64_t position);
+
+    bool is_open() const noexcept { return fd_ >= 0; }
+    int fd() const noexcept { return fd_; } // ֻ˳ʾ򿪵ļ
+    std::uint64_t size() const noexcept { return size_; }
+
+private:
+    int fd_ = -1;
+    std::uint64_t size_ = 0; // ļС
+    std::size_t readahead_ = 0; // Ԥ
+    bool drop_behind_ = false;
+    std::uint64_t prefetched_ = 0; // Ԥλ
+    std::uint64_t dropped_ = 0; // Ѷλ
+};
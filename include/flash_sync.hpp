@@ -0,0 +1,37 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "frame_extractor.hpp"
+#include "sync_offsets.hpp"
+#include "video_source.hpp"
+
+// ⣨İ壩ͬûĻλ
+struct FlashSyncOptions {
+    int thumbnail_width = 64; // ͳƽȵͼȣֱóߴ
+    double analysis_seconds = 120.0; // ֻɨÿ·ͷʱ
+    double min_jump = 20.0; // ֡ƽȣ0~255ԾֵΪһ
+    double max_offset_seconds = 30.0; // ƫΧ
+    double match_tolerance_ms = 100.0; // ·ʱڸ÷ΧΪͬһ
+    int reference_cam = -1; // οӽǣ-1 ʾСĿӽ
+    VideoSourceOptions source; // ˲LibAV ˿ֱ I420ת
+};
+
+// һ·Ƶ֡ƽ
+struct LumaTrack {
+    std::vector<float> luma; // ÿ֡ͼƽ
+    double fps = 0.0; // ֡
+};
+
+// ֡ͼͳƽȣcv::mean  SIMD Լ
+bool measure_luma_track(const std::filesystem::path& path, const FlashSyncOptions& options,
+                        LumaTrack& track);
+
+// ҳԾʼʱ̣룩ԾԽ֡ʱֵ֡֡ʱ̡
+std::vector<double> detect_flashes(const LumaTrack& track, double min_jump);
+
+// ÿ·Ƶڸ߳ͳȲ⣬ٰʱοӽƥƫƣοӽǵƫΪ 0
+// ŶΪƥϵռ·н϶һıδ⵽ӽǲڽС
+SyncOffsets estimate_flash_offsets(const std::vector<CameraVideo>& videos,
+                                   const FlashSyncOptions& options);
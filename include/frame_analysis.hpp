@@ -0,0 +1,14 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include "frame_batch.hpp"
+
+// ׶Σ˶ȡͷлõͼȵȱСĻҶͼ
+// width <= 0 СԭʱֻҶתд thumbnailߴ粻ʱڴ档
+// I420 ֱ֡С Y ƽ棬ɫת
+void make_analysis_thumbnail(const cv::Mat& frame, FramePixelFormat format, int width,
+                             cv::Mat& thumbnail);
+
+// ȣͼҶȣ˹ӦķԽԽ˶ģ֡ƫ͡
+double sharpness_score(const cv::Mat& thumbnail);
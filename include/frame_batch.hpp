@@ -1,45 +1,116 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <vector>
 
 #include <opencv2/core.hpp>
 
+#include "memory_budget.hpp"
+
+// ֡ظʽ
+enum class FramePixelFormat {
+    BGR, // CV_8UC3
+    Gray, // CV_8UC1
+    I420, // ԭ YUV420 ƽʽCV_8UC1߶Ϊͼ߶ȵ 3/2ʹôת frame_format.hpp
+};
+
 // ͬ֡Ľṹ
 struct FrameBatch {
     int frame_index = -1; //֡
     double timestamp = 0.0; //ʱ
+    int segment_id = 0; //Ƭαţͷл
+    FramePixelFormat pixel_format = FramePixelFormat::BGR; //frames и֡ظʽ
     std::map<int, cv::Mat> frames; //֡
+    std::map<int, double> sharpness; //ӽȣ˹δʱΪ
+    std::vector<int> missing_cams; //ȱʧӽǣ StreamErrorPolicy ˶ȡʧܣ
+    std::shared_ptr<MemoryReservation> reservation; //֡ռõڴԤ㣬εиͷź黹δԤʱΪ
 
     bool is_valid() const noexcept { return !frames.empty(); } //֡ǷЧ
 };
 
+// ͳƣBlockingQueue::enable_stats ֮ʼۼƣ
+struct QueueStats {
+    std::size_t depth = 0; // ǰ
+    std::size_t high_water = 0; // 
+    double average_depth = 0.0; // ʱȨƽ
+    std::uint64_t pushes = 0; // ɹӴ
+    std::uint64_t pops = 0; // ɹӴ
+    std::uint64_t push_blocked = 0; // push ȴĴ
+    double push_blocked_seconds = 0.0; // push ȴʱ
+    double push_blocked_max_seconds = 0.0; // push εȴʱ
+    std::uint64_t pop_blocked = 0; // pop пնȴĴ
+    double pop_blocked_seconds = 0.0; // pop ȴʱ
+    double pop_blocked_max_seconds = 0.0; // pop εȴʱ
+};
+
 // ̰߳ȫУ̻߳µİȫһ߳̿ݣһ߳̿ȡ
+// capacity Ϊ 0 ʾʱ push ֱȡݻйر
+// push ȴࡢpop ˵ƿ֮˵ƿ
 template <typename T>
 class BlockingQueue {
 public:
-    void push(T value) {
+    explicit BlockingQueue(std::size_t capacity = 0) : capacity_(capacity) {}
+
+    //  false ʾѹرգݱ߾ݴǰ˳
+    bool push(T value) {
         {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::unique_lock<std::mutex> lock(mutex_);
+            wait(lock, not_full_, push_wait_, [this]() {
+                return closed_ || capacity_ == 0 || queue_.size() < capacity_;
+            });
             if (closed_) {
-                return;
+                return false;
             }
+            note_depth_change();
             queue_.emplace(std::move(value));
+            if (stats_enabled_) {
+                ++pushes_;
+                high_water_ = std::max(high_water_, queue_.size());
+            }
         }
-        cv_.notify_one();
+        not_empty_.notify_one();
+        return true;
     }
 
     std::optional<T> pop() {
         std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [this]() { return closed_ || !queue_.empty(); });
+        wait(lock, not_empty_, pop_wait_, [this]() { return closed_ || !queue_.empty(); });
         if (queue_.empty()) {
             return std::nullopt;
         }
+        note_depth_change();
         T value = std::move(queue_.front());
         queue_.pop();
+        if (stats_enabled_) {
+            ++pops_;
+        }
+        lock.unlock();
+        not_full_.notify_one();
+        return value;
+    }
+
+    // ȴΪʱ std::nullopt closed() Ƿѹرգ
+    std::optional<T> try_pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (queue_.empty()) {
+            return std::nullopt;
+        }
+        note_depth_change();
+        T value = std::move(queue_.front());
+        queue_.pop();
+        if (stats_enabled_) {
+            ++pops_;
+        }
+        lock.unlock();
+        not_full_.notify_one();
         return value;
     }
 
@@ -48,7 +119,8 @@ public:
             std::lock_guard<std::mutex> lock(mutex_);
             closed_ = true;
         }
-        cv_.notify_all();
+        not_empty_.notify_all();
+        not_full_.notify_all();
     }
 
     bool empty() const {
@@ -61,16 +133,106 @@ public:
         return queue_.size();
     }
 
+    std::size_t capacity() const noexcept { return capacity_; }
+
     bool closed() const noexcept {
         std::lock_guard<std::mutex> lock(mutex_);
         return closed_;
     }
 
+    // ʼͳȴʱ䣻δʱ push/pop ʱ
+    void enable_stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stats_enabled_) {
+            return;
+        }
+        stats_enabled_ = true;
+        stats_start_ = last_change_ = Clock::now();
+        high_water_ = queue_.size();
+    }
+
+    // ǰͳƣʱ̿ɵ
+    QueueStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        QueueStats result;
+        result.depth = queue_.size();
+        if (!stats_enabled_) {
+            return result;
+        }
+        const auto now = Clock::now();
+        const double elapsed = seconds(now - stats_start_);
+        const double integral = depth_integral_ + queue_.size() * seconds(now - last_change_);
+        result.high_water = high_water_;
+        result.average_depth = elapsed > 0.0 ? integral / elapsed : static_cast<double>(queue_.size());
+        result.pushes = pushes_;
+        result.pops = pops_;
+        result.push_blocked = push_wait_.count;
+        result.push_blocked_seconds = push_wait_.total_seconds;
+        result.push_blocked_max_seconds = push_wait_.max_seconds;
+        result.pop_blocked = pop_wait_.count;
+        result.pop_blocked_seconds = pop_wait_.total_seconds;
+        result.pop_blocked_max_seconds = pop_wait_.max_seconds;
+        return result;
+    }
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    // һࣨpush  popĵȴͳ
+    struct WaitStats {
+        std::uint64_t count = 0;
+        double total_seconds = 0.0;
+        double max_seconds = 0.0;
+    };
+
+    static double seconds(Clock::duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    // ʱȴͳʱֻʱʱ
+    template <typename Predicate>
+    void wait(std::unique_lock<std::mutex>& lock, std::condition_variable& condition,
+              WaitStats& wait_stats, Predicate ready) {
+        if (ready()) {
+            return;
+        }
+        if (!stats_enabled_) {
+            condition.wait(lock, ready);
+            return;
+        }
+        const auto start = Clock::now();
+        condition.wait(lock, ready);
+        const double waited = seconds(Clock::now() - start);
+        ++wait_stats.count;
+        wait_stats.total_seconds += waited;
+        wait_stats.max_seconds = std::max(wait_stats.max_seconds, waited);
+    }
+
+    // ȼ仯ѾȰʱۼӣ÷
+    void note_depth_change() {
+        if (!stats_enabled_) {
+            return;
+        }
+        const auto now = Clock::now();
+        depth_integral_ += queue_.size() * seconds(now - last_change_);
+        last_change_ = now;
+    }
+
     mutable std::mutex mutex_;
-    std::condition_variable cv_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
     std::queue<T> queue_;
+    const std::size_t capacity_;
     bool closed_ = false;
-};
-
 
+    // ͳ mutex_ 
+    bool stats_enabled_ = false;
+    Clock::time_point stats_start_; // ʼͳƵʱ
+    Clock::time_point last_change_; // ϴα仯ʱ
+    double depth_integral_ = 0.0; // ȶʱĻ֣룩
+    std::size_t high_water_ = 0;
+    std::uint64_t pushes_ = 0;
+    std::uint64_t pops_ = 0;
+    WaitStats push_wait_;
+    WaitStats pop_wait_;
+};
@@ -1,13 +1,64 @@
 #pragma once
 
 #include <filesystem>
+#include <map>
+#include <vector>
 
 #include "frame_batch.hpp"
+#include "video_source.hpp"
+
+// زĿ֡ʱʱԴ֡ĶӦʽ
+enum class FrameResample {
+    Nearest, // ȡʱԴ֡
+    Blend, // ʱԻǰ֡
+};
+
+// ĳһ·Ƶȡʧܣļضϡ𻵣ʱĴʽ
+enum class StreamErrorPolicy {
+    Stop, // ֡Ĭϣ
+    DropCamera, // βٰӽǣӽǼ
+    PartialBatch, // ճӽǼ FrameBatch::missing_cams
+    SeekPastError, //  seek_skip_seconds 룬þ PartialBatch 
+};
+
+// ֡˶ȡͬȷ׶ֻҪͼ
+// ýֱСߴ/Ҷ֡֡вתȫֱ BGR ֡
+// source.native_yuv Ϊ true Һ֧ʱЯ I420 ֡ڴ룬ɫתƳٵʹô
+struct ExtractOptions {
+    int decode_width = 0; // >0 ʱÿ֡Сÿȣȱȣӣ source.output_width
+    bool grayscale = false; // ֻҶ֡
+    int frame_step = 1; // ÿ frame_step ֡һֻ֡֡ grab ɫת
+    double target_fps = 0.0; // >0 ʱ֡ӽǰԼ֡ʻԴ֡ frame_step
+    FrameResample resample = FrameResample::Nearest; // target_fps Чʱزʽ
+    VideoSourceOptions source; // ˲
+    StreamErrorPolicy error_policy = StreamErrorPolicy::Stop; // ·ƵȡʧʱĴʽ
+    double seek_skip_seconds = 1.0; // SeekPastError ÿʱͨԽ𻵵 GOP
+    int max_seek_retries = 3; // SeekPastError ÿ·ƵĴ
+    std::map<int, double> camera_offsets_ms; // ӽǵͬƫƣ룬 sync_offsets.hppȱʡΪ 0
+    MemoryBudget* memory_budget = nullptr; // ǿʱÿǰ֡ݴСԤԤþʱͣ
+};
+
+// Ŀ¼µһ·Ƶ
+struct CameraVideo {
+    int cam_id = -1; // ͷIDȡԸĿ¼ cam_N򰴷˳
+    std::filesystem::path path; // Ƶ·
+};
+
+// ݹ input_dir µƵļ cam_id 
+std::vector<CameraVideo> find_camera_videos(const std::filesystem::path& input_dir);
 
 // ̱߳Ŀ¼µƵ֡β͵С
-// ԶرնС
-void extract_frames_single(const std::filesystem::path& input_dir,
-                           BlockingQueue<FrameBatch>& output_queue);
+// ԶرնУǰرնʱֹͣ벢ء
+// ·Ƶȡʧʱ error_policy ӽǶرնС
+// ε frame_index ΪԴƵе֡ţ֡ʱͬƫʱΪ֡ţ
+//  target_fps ʱΪʱ̵ţtimestamp = frame_index / target_fps
+// ᱻѡеԴֻ֡ grab ɫת
+// ڴԤ㱻رʱбرһֹͣ롣
+//  false ʾĿ¼ڡûпƵ޷زStop ¶ȡʧܣ
+// ǰرշ true
+bool extract_frames_single(const std::filesystem::path& input_dir,
+                           BlockingQueue<FrameBatch>& output_queue,
+                           const ExtractOptions& options = {});
 
 
 
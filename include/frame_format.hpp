@@ -0,0 +1,23 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+
+#include "frame_batch.hpp"
+
+// ظʽתI420 ֡ BGR һڴ棬ɫתƳٵʹôźϲɣ
+// ֻҪȵķ׶ֱȡ Y ƽ棬ҪС YUV ƽСת
+
+// ֡ͼߴ磨I420  Mat ߶Ϊͼ߶ȵ 3/2
+cv::Size frame_image_size(const cv::Mat& frame, FramePixelFormat format);
+
+// ȣҶȣͼI420  Y ƽͼҶ֡ԭأBGR ֡ת buffer 󷵻 buffer
+cv::Mat frame_luma(const cv::Mat& frame, FramePixelFormat format, cv::Mat& buffer);
+
+// תΪ 3 ͨ 8 λ BGRrgb Ϊ true ʱΪ RGBsize ǿʱͬʱŵóߴ硣
+// ߴ硢Ͳʱ out ڴ棻BGR ֡κδʱ out  frame ء
+void convert_frame(const cv::Mat& frame, FramePixelFormat format, cv::Mat& out, bool rgb = false,
+                   cv::Size size = cv::Size());
+
+// I420 תΪ BGR д converted  convertedʽֱӷ batch
+//  PNGnpyڴȰ BGR/ҶԼĵطʹá
+const FrameBatch& to_bgr_batch(const FrameBatch& batch, FrameBatch& converted);
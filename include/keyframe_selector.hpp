@@ -0,0 +1,41 @@
+#pragma once
+
+#include <map>
+
+#include "frame_batch.hpp"
+
+// ˶ؼ֡ѡ
+struct KeyframeOptions {
+    int thumbnail_width = 160; // ˶ʹõͼ
+    double motion_threshold = 3.0; // ӽͼƽԲҶ 0-255ľֵֵ
+    int max_gap = 30; // ϴﵽֵʱǿ<=0 ʾ
+};
+
+// ˶ؼ֡ѡһεͼȽϣֻг㹻仯
+// ϴ̫ãʱŰؽֹ治
+class KeyframeSelector {
+public:
+    explicit KeyframeSelector(const KeyframeOptions& options) : options_(options) {}
+
+    //  true ʾӦ
+    bool select(const FrameBatch& batch);
+
+    double last_motion() const noexcept { return last_motion_; }
+    std::size_t selected() const noexcept { return selected_; }
+    std::size_t total() const noexcept { return total_; }
+
+private:
+    KeyframeOptions options_; // ѡ
+    std::map<int, cv::Mat> reference_; // һθӽǵͼ
+    cv::Mat thumbnail_; // õͼ
+    cv::Mat diff_; // õĲֻ
+    int gap_ = 0; // ϴ
+    double last_motion_ = 0.0; // һ˶
+    std::size_t selected_ = 0; // 
+    std::size_t total_ = 0; // Ѵ
+};
+
+// ؼ֡׶Σ input ȡΣֻѡе͵ outputر output
+// output ߹رʱͬʱر inputֹͣ롣
+void select_keyframes(BlockingQueue<FrameBatch>& input, BlockingQueue<FrameBatch>& output,
+                      const KeyframeOptions& options);
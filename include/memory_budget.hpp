@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// ȫˮ߹õڴԤ㣨ֽڣ֡ǰԤ֡һͷʱ黹
+// Ԥþʱֵڴӽֱʡȡ;д޹أֻԤơ
+class MemoryBudget {
+public:
+    // limit_bytes Ϊ 0 ʾƣֻͳƣ
+    explicit MemoryBudget(std::size_t limit_bytes,
+                          std::chrono::milliseconds stall_timeout = std::chrono::seconds(10));
+
+    // Ԥ bytesԤ㲻ʱ false ʾԤѹرգˮ˳
+    // 󳬹ԤʱԤȫ黹У
+    // ȴ stall_timeout ڼûκι黹ʱ˵ڵȸ룬ֻһ󲢸澯
+    // 澯Ƶڼķд֮Ԥơ
+    bool acquire(std::size_t bytes);
+    void release(std::size_t bytes);
+    // Ѳеȴߣ֮ acquire ֱӷ false
+    void close();
+    // ˮ߱ͬʱеʱ䴰ڵȣһ󵽴ʱС飬
+    // ԤɲôʱߵС澯ÿζͣ͵ʱ
+    void set_min_batches(std::size_t batches);
+
+    std::size_t limit() const;
+    std::size_t used() const;
+    std::size_t peak() const;
+    std::uint64_t blocked_count() const; // acquire Ĵ
+    double blocked_seconds() const; // acquire ʱ
+    std::uint64_t overcommits() const; // ͣͳеĴ
+
+private:
+    std::size_t limit_;
+    const std::chrono::milliseconds stall_timeout_;
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    std::size_t used_ = 0;
+    std::size_t peak_ = 0;
+    std::uint64_t releases_ = 0; // 黹жϵȴڼǷнչ
+    std::uint64_t blocked_count_ = 0;
+    double blocked_seconds_ = 0.0;
+    std::uint64_t overcommits_ = 0;
+    std::uint64_t overcommits_logged_ = 0; // ϴθ澯ʱĳд
+    std::chrono::steady_clock::time_point overcommit_logged_at_; // ϴθ澯ʱ
+    std::size_t min_batches_ = 0;
+    bool min_checked_ = false; // Ѱһ min_batches_
+    bool closed_ = false;
+};
+
+// һԤʱ黹ͨ shared_ptr УεиСɸѡ׶Ρ
+// ʱ䴰ڡд񣩶ͷźŹ黹Ԥ㡣
+class MemoryReservation {
+public:
+    MemoryReservation(MemoryBudget& budget, std::size_t bytes) noexcept : budget_(&budget), bytes_(bytes) {}
+    MemoryReservation(const MemoryReservation&) = delete;
+    MemoryReservation& operator=(const MemoryReservation&) = delete;
+    ~MemoryReservation() { budget_->release(bytes_); }
+
+    std::size_t bytes() const noexcept { return bytes_; }
+
+private:
+    MemoryBudget* budget_;
+    std::size_t bytes_;
+};
+
+// Ԥ bytes س shared_ptrbudget Ϊʱؿָ룬ԤرʱҲؿָ
+std::shared_ptr<MemoryReservation> reserve_memory(MemoryBudget* budget, std::size_t bytes);
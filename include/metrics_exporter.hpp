@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "pipeline_metrics.hpp"
+
+//  PipelineMetrics ʽΪ Prometheus ıʽversion 0.0.4
+// ׶κʱֱͼֽ֡¼ȴʱ䡢̳פڴ
+std::string format_prometheus(const PipelineMetrics& metrics);
+
+// Prometheus 
+struct MetricsExportOptions {
+    std::filesystem::path textfile; // ǿʱдļ node_exporter  textfile collector ȡ
+    std::chrono::milliseconds interval{10000}; // ļд
+    int http_port = 0; // >0 ʱڸö˿ṩ /metrics
+    std::string http_address = "127.0.0.1"; // ַҪԶץȡʱΪ 0.0.0.0
+};
+
+// ̨̣߳д textfileѡӦ HTTP ץȡ
+class MetricsExporter {
+public:
+    explicit MetricsExporter(PipelineMetrics& metrics) : metrics_(metrics) {}
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    bool start(const MetricsExportOptions& options);
+    // ֹ̣ͣ߳дһ textfile
+    void stop();
+
+private:
+    void run();
+    bool open_listener();
+    void serve_pending();
+    bool write_textfile() const;
+
+    PipelineMetrics& metrics_;
+    MetricsExportOptions options_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable stop_cv_;
+    bool stop_requested_ = false;
+    bool running_ = false;
+    int listen_fd_ = -1; // HTTP ׽
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "batch_tensor.hpp"
+#include "frame_batch.hpp"
+
+// .npy ļʽд
+// ͷֻдһΣΪάԤ̶ȣֱӴ Mat/ڴ׷д룬
+// رʱԭػάȣPython ˿ֱ np.load(mmap_mode='r')
+class NpyWriter {
+public:
+    enum class DType { UInt8, Float32 };
+
+    NpyWriter() = default;
+    NpyWriter(const NpyWriter&) = delete;
+    NpyWriter& operator=(const NpyWriter&) = delete;
+    ~NpyWriter();
+
+    // stacked=true ʱļ״Ϊ [N, item_shape...]N д
+    // stacked=false ʱļ״ item_shapeֻдһԪء
+    bool open(const std::filesystem::path& path, DType dtype,
+              const std::vector<std::int64_t>& item_shape, bool stacked);
+    // дһ [cams, H, W, 3]  uint8 ԪأBGR ͨ˳ Mat һ£I420 ת
+    bool write_frames(const FrameBatch& batch);
+    // дһ [cams, 3, H, W]  float32 Ԫ
+    bool write_tensor(const BatchTensor& tensor);
+    bool close();
+
+    bool is_open() const noexcept { return file_.is_open(); }
+    std::int64_t count() const noexcept { return count_; }
+
+private:
+    std::string header_text() const;
+    bool write_bytes(const void* data, std::size_t bytes);
+
+    std::ofstream file_; // ļ
+    std::filesystem::path path_; // ļ·
+    DType dtype_ = DType::UInt8; // Ԫ
+    std::vector<std::int64_t> item_shape_; // Ԫص״
+    bool stacked_ = false; // Ƿά
+    std::int64_t count_ = 0; // дԪ
+    std::size_t header_size_ = 0; // ͷֽ
+};
+
+// .npy 
+enum class NpyContent {
+    Frames, // ԭʼ uint8 ֡ [cams, H, W, 3]
+    Tensor, // Ԥ float32  [cams, 3, H, W]
+};
+
+// .npy ε
+struct NpyExportOptions {
+    NpyContent content = NpyContent::Frames; // 
+    int batches_per_file = 1; // ÿļ1 ʾÿεһάļ
+    TensorOptions tensor; // content Ϊ Tensor ʱԤ
+};
+
+// ͬΰд output_dir µ chunk_XXXXXX.npy
+//  index.csv м¼ÿļкš֡ʱ
+class NpyBatchExporter {
+public:
+    NpyBatchExporter(std::filesystem::path output_dir, NpyExportOptions options);
+    ~NpyBatchExporter();
+
+    bool write(const FrameBatch& batch);
+    bool close();
+
+    std::size_t files_written() const noexcept { return files_written_; }
+
+private:
+    bool start_file(const std::vector<std::int64_t>& item_shape);
+
+    std::filesystem::path output_dir_; // Ŀ¼
+    NpyExportOptions options_; // 
+    NpyWriter writer_; // ǰļд
+    std::shared_ptr<TensorBufferPool> tensor_pool_; // أд꼴
+    std::ofstream index_; // ļ
+    std::vector<std::int64_t> item_shape_; // ǰļԪ״
+    std::string current_name_; // ǰļ
+    FrameBatch converted_; // I420 תΪ BGR ֡
+    std::size_t files_written_ = 0; // Ѵļ
+};
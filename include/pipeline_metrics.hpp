@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "frame_batch.hpp"
+
+// ӳֱͼHDR Ķ-ԷͰÿ 2 ٵȷ 16 ͰԼ 6%
+// ¼ֻԭӼӣڶ̵߳ѭͬʱá
+class LatencyHistogram {
+public:
+    void record(std::uint64_t nanoseconds) noexcept;
+
+    std::uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+    std::uint64_t total_ns() const noexcept { return total_ns_.load(std::memory_order_relaxed); }
+    std::uint64_t max_ns() const noexcept { return max_ns_.load(std::memory_order_relaxed); }
+    // λ0~1ͰϽ磨ֵûм¼ʱΪ 0
+    std::uint64_t percentile_ns(double quantile) const noexcept;
+    //  bound_ns ļ¼ۻͰʹ
+    std::uint64_t count_at_most(std::uint64_t bound_ns) const noexcept;
+
+private:
+    static constexpr int kSubBits = 4; // ÿ 2 ķͰλ
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kBucketCount = kSubBuckets + (64 - kSubBits) * kSubBuckets;
+
+    static int bucket_index(std::uint64_t value) noexcept;
+    static std::uint64_t bucket_upper(int index) noexcept;
+
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> total_ns_{0};
+    std::atomic<std::uint64_t> max_ns_{0};
+};
+
+// һ׶Σɰӽ֣ĺʱֲ
+struct StageMetrics {
+    std::string stage; // ׶ decodequeue_pushimencode
+    int cam_id = -1; // ӽǱţ-1 ʾӽ
+    LatencyHistogram latency; // ÿεõĺʱ
+    std::atomic<std::uint64_t> bytes{0}; // ֽд֡ݵȣ
+
+    void add(std::uint64_t nanoseconds, std::uint64_t byte_count = 0) noexcept {
+        latency.record(nanoseconds);
+        if (byte_count != 0) {
+            bytes.fetch_add(byte_count, std::memory_order_relaxed);
+        }
+    }
+};
+
+// ¼綪֡
+struct MetricCounter {
+    std::string name; //  frames_dropped
+    int cam_id = -1; // ӽǱţ-1 ʾӽ
+    std::atomic<std::uint64_t> value{0};
+
+    void add(std::uint64_t count = 1) noexcept { value.fetch_add(count, std::memory_order_relaxed); }
+};
+
+// ȫ̵Ľ׶ָĬϹرգstage()  nullptrʱֱ
+// ѭȡ StageMetrics ָ룬ѭֻԭӲٲ
+class PipelineMetrics {
+public:
+    void set_enabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    // ȡãҪʱ׶εָꣻδʱ nullptr
+    StageMetrics* stage(const std::string& name, int cam_id = -1);
+    // ǰȫ׶Σ׶ӽָڽЧ
+    std::vector<const StageMetrics*> stages() const;
+
+    // ȡãҪʱδʱ nullptr
+    MetricCounter* counter(const std::string& name, int cam_id = -1);
+    std::vector<const MetricCounter*> counters() const;
+
+    // ǼһУ enable_statsӡ뵼ʱȡͳƣڵǰִ
+    void add_queue(const std::string& name, std::function<QueueStats()> stats);
+    std::vector<std::pair<std::string, QueueStats>> queues() const;
+
+    // ӡ׶εĴp50/p99/max ʱ룩
+    void print(std::ostream& out) const;
+    bool save_json(const std::filesystem::path& path) const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::pair<std::string, int>, std::unique_ptr<StageMetrics>> stages_;
+    std::map<std::pair<std::string, int>, std::unique_ptr<MetricCounter>> counters_;
+    std::vector<std::pair<std::string, std::function<QueueStats()>>> queues_;
+    std::atomic<bool> enabled_{false};
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
+
+PipelineMetrics& pipeline_metrics();
+
+// ʱʱѺʱ׶Σstage Ϊ nullptr ʱȡʱ
+class StageTimer {
+public:
+    explicit StageTimer(StageMetrics* stage) noexcept : stage_(stage) {
+        if (stage_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+    ~StageTimer() {
+        if (stage_) {
+            const auto elapsed = std::chrono::steady_clock::now() - start_;
+            stage_->add(static_cast<std::uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                        bytes_);
+        }
+    }
+
+    void set_bytes(std::uint64_t bytes) noexcept { bytes_ = bytes; }
+
+private:
+    StageMetrics* stage_;
+    std::chrono::steady_clock::time_point start_;
+    std::uint64_t bytes_ = 0;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// һʱ䣨Chrome trace  "X" ¼
+struct TraceEvent {
+    const char* name = nullptr; // Ϊַָֻ룩
+    int cam_id = -1; // ӽǱţ-1 ʾӽ
+    std::int64_t frame_index = -1; // ֡ţ-1 ʾ
+    std::int64_t begin_ns = 0; // ԸĿʼʱ
+    std::int64_t duration_ns = 0; // ʱ
+};
+
+// ̵߳¼壺ֻ߳׷ӣ̶СĿʽ
+// ߳̿дضȡѷ¼
+class ThreadTraceBuffer {
+public:
+    explicit ThreadTraceBuffer(int thread_id);
+    ~ThreadTraceBuffer();
+    ThreadTraceBuffer(const ThreadTraceBuffer&) = delete;
+    ThreadTraceBuffer& operator=(const ThreadTraceBuffer&) = delete;
+
+    void append(const TraceEvent& event);
+    // д˳ѷ¼
+    template <typename Visitor>
+    void for_each(Visitor visit) const {
+        for (const Chunk* chunk = head_.get(); chunk != nullptr;
+             chunk = chunk->next.load(std::memory_order_acquire)) {
+            const std::size_t size = chunk->size.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < size; ++i) {
+                visit(chunk->events[i]);
+            }
+        }
+    }
+
+    int thread_id() const noexcept { return thread_id_; }
+
+private:
+    static constexpr std::size_t kChunkEvents = 4096;
+    struct Chunk {
+        std::array<TraceEvent, kChunkEvents> events;
+        std::atomic<std::size_t> size{0};
+        std::atomic<Chunk*> next{nullptr};
+    };
+
+    std::unique_ptr<Chunk> head_; // һ飬 next ʱͷ
+    Chunk* tail_ = nullptr; // ǰдĿ飨̷ֻ߳ʣ
+    const int thread_id_;
+};
+
+// ˮʱ߸٣ѡṵ́߳ѽ롢ͬеȴд
+// ԵĻ壬ʱΪ Chrome trace JSONchrome://tracing  ui.perfetto.dev 򿪣
+// δʱÿֻһԭӶ
+class PipelineTracer {
+public:
+    void set_enabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    // Ըĵǰʱ
+    std::int64_t now_ns() const noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - start_)
+            .count();
+    }
+
+    void record(const TraceEvent& event);
+    // ǰ߳ʾʱߵ
+    void name_thread(const std::string& name);
+
+    // дѼ¼ȫ¼ͨڸ߳̽
+    bool save(const std::filesystem::path& path) const;
+
+private:
+    ThreadTraceBuffer& thread_buffer();
+
+    std::atomic<bool> enabled_{false};
+    const std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    mutable std::mutex mutex_; // ֻб߳¼д벻
+    std::vector<std::unique_ptr<ThreadTraceBuffer>> buffers_;
+    std::vector<std::pair<int, std::string>> thread_names_;
+};
+
+PipelineTracer& pipeline_tracer();
+
+// 䣺ʱ¿ʼʱ䣬ʱд뵱ǰ̵߳Ļ
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, int cam_id = -1, std::int64_t frame_index = -1) noexcept {
+        PipelineTracer& tracer = pipeline_tracer();
+        if (tracer.enabled()) {
+            event_.name = name;
+            event_.cam_id = cam_id;
+            event_.frame_index = frame_index;
+            event_.begin_ns = tracer.now_ns();
+        }
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    ~TraceSpan() {
+        if (event_.name != nullptr) {
+            PipelineTracer& tracer = pipeline_tracer();
+            event_.duration_ns = tracer.now_ns() - event_.begin_ns;
+            tracer.record(event_);
+        }
+    }
+
+private:
+    TraceEvent event_;
+};
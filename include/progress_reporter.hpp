@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// һһ·Ƶһ̵֡ȣĽȣѭֻԭӼ
+struct ProgressCounter {
+    std::string name; // ʾ "ingest cam 0"
+    std::atomic<std::int64_t> total_frames{0}; // Ԥ֡CAP_PROP_FRAME_COUNT ȣ0 ʾδ֪
+    std::atomic<std::uint64_t> frames{0}; // Ѵ֡
+    std::atomic<std::uint64_t> bytes_read{0}; // 루ֽ
+    std::atomic<std::uint64_t> bytes_written{0}; // дֽ
+    std::atomic<bool> finished{false}; // ѽ
+    std::atomic<double> seconds{0.0}; // ʱ¼ܺʱյƽ
+    const std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+    void add_frames(std::uint64_t count, std::uint64_t read = 0, std::uint64_t written = 0) noexcept {
+        frames.fetch_add(count, std::memory_order_relaxed);
+        if (read != 0) {
+            bytes_read.fetch_add(read, std::memory_order_relaxed);
+        }
+        if (written != 0) {
+            bytes_written.fetch_add(written, std::memory_order_relaxed);
+        }
+    }
+
+    void finish() noexcept {
+        seconds.store(std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count(),
+                      std::memory_order_relaxed);
+        finished.store(true, std::memory_order_release);
+    }
+};
+
+// Ȼ㱨ǼǼ̶̰߳ȡӡ֡ʣʱ䡣
+// ĬϹرգadd()  nullptrѭݴ
+class ProgressReporter {
+public:
+    ~ProgressReporter();
+
+    // Ǽһδ㱨ʱ nullptrָڽЧ
+    ProgressCounter* add(const std::string& name, std::int64_t total_frames = 0);
+
+    // ̣߳ÿ interval ӡһΣstop() ʱӡս
+    void start(std::chrono::milliseconds interval, std::ostream& out);
+    void stop();
+    bool running() const noexcept { return running_.load(std::memory_order_relaxed); }
+
+    // ӡǰȣÿһУskip_reported Ϊ true ʱѱ
+    void report(std::ostream& out, bool skip_reported = false);
+
+private:
+    void run(std::chrono::milliseconds interval, std::ostream& out);
+
+    std::mutex mutex_; // бֹͣ־
+    std::condition_variable stop_cv_;
+    std::vector<std::unique_ptr<ProgressCounter>> counters_;
+    std::vector<std::uint64_t> last_frames_; // ϴαʱ֡ڼ˲ʱ
+    std::vector<char> reported_finished_; // Ƿѱ
+    std::chrono::steady_clock::time_point last_report_;
+    std::thread thread_;
+    std::ostream* out_ = nullptr;
+    std::atomic<bool> running_{false};
+    bool stop_requested_ = false;
+};
+
+ProgressReporter& progress_reporter();
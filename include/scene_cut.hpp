@@ -0,0 +1,39 @@
+#pragma once
+
+#include <map>
+
+#include "frame_batch.hpp"
+
+// ͷл
+struct SceneCutOptions {
+    int thumbnail_width = 160; // ֱͼʹõͼ
+    int bins = 64; // ҶֱͼͰ
+    double threshold = 0.35; // ֱͼϾ루ӽƽֵΪл
+    int min_segment_length = 15; // Ƭٰ˸Ƭ
+};
+
+// ֱͼľͷл⣺ʱ̵ĻҶֱͼͻ䣨λƶصƣʱ
+// ʼµƬΣƬαд batch.segment_id
+class SceneCutDetector {
+public:
+    explicit SceneCutDetector(const SceneCutOptions& options) : options_(options) {}
+
+    // ΪδƬαţ true ʾƬεĵһ
+    bool process(FrameBatch& batch);
+
+    int segment_id() const noexcept { return segment_id_; }
+    double last_distance() const noexcept { return last_distance_; }
+
+private:
+    SceneCutOptions options_; // 
+    std::map<int, cv::Mat> previous_; // һθӽǵĹһֱͼ
+    cv::Mat thumbnail_; // õͼ
+    int segment_id_ = 0; // ǰƬα
+    int segment_length_ = 0; // ǰƬѰ
+    double last_distance_ = 0.0; // һεֱͼ
+};
+
+// ͷл׶ΣΪÿδƬαź͵ outputر output
+// output ߹رʱͬʱر input
+void tag_scene_cuts(BlockingQueue<FrameBatch>& input, BlockingQueue<FrameBatch>& output,
+                    const SceneCutOptions& options);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <optional>
+
+#include "frame_batch.hpp"
+
+// Ų
+struct SharpnessOptions {
+    int thumbnail_width = 320; // ʹõͼ
+    int window = 0; // ÿ window ֻһ<=1 ʾֲֻɸѡ
+};
+
+// ÿӽǵȣд batch.sharpness
+void score_sharpness(FrameBatch& batch, int thumbnail_width);
+
+// εȣȡӽеСֵκһӽģӰؽ
+double batch_sharpness(const FrameBatch& batch);
+
+//  window ɵʱ䴰ѡͬʱ
+class SharpestSelector {
+public:
+    explicit SharpestSelector(const SharpnessOptions& options) : options_(options) {}
+
+    // һΣᱻ֣ڽʱش
+    std::optional<FrameBatch> push(FrameBatch batch);
+    // ʱһе
+    std::optional<FrameBatch> flush();
+
+private:
+    SharpnessOptions options_; // 
+    std::optional<FrameBatch> best_; // ǰ
+    double best_score_ = 0.0; // best_ 
+    int count_ = 0; // ǰѴ
+};
+
+// Ƚ׶ΣΪÿ֣window > 1 ʱÿֻһ
+// ر outputoutput ߹رʱͬʱر input
+void select_sharpest(BlockingQueue<FrameBatch>& input, BlockingQueue<FrameBatch>& output,
+                     const SharpnessOptions& options);
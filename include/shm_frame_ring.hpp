@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "frame_batch.hpp"
+
+//  POSIX ڴͬ֡λڰ㿽ؽ̡
+// ддˣ̣֡λˣ̣ӳͬһڴֱӶȡ
+//
+// ڴ沼֣Сˣ 64 ֽڶ룩
+//   [0, 128)                     ShmRingHeader
+//   [128 + i * slot_stride, ...)  i λShmSlotHeader + cam_ids[max_cams]
+//                                 max_cams  frame_stride ֽڵ֡ݣHWCuint8BGR
+//  seq ڲλ seq % slot_count С
+// дˣstate=Writing -> ֡ -> дԪ -> seq -> state=Ready -> write_seq=seq+1
+// ˣȴ write_seq > seq Ҳλ state==Readyƥ -> ȡ -> state=Empty -> read_seq=seq+1
+// д write_seq - read_seq == slot_count ʱȴͷŲλ֡ûж
+// reader_pid Ϊ 0 ý˳δʱһֱȴӣ
+// ֻʽҪ drop_without_reader ʱֱӶ CAS Ǽ reader_pidͬһʱֻһˡ
+// д˸ͷǼǽ̺ţͬڴдԴʱ create ʧܣռ
+namespace shm_ring {
+constexpr char kMagic[8] = {'V', 'G', 'G', 'T', 'R', 'N', 'G', '1'};
+constexpr std::uint32_t kVersion = 2;
+constexpr std::size_t kHeaderBytes = 128;
+constexpr std::size_t kAlignment = 64;
+
+enum SlotState : std::uint32_t {
+    kSlotEmpty = 0,
+    kSlotWriting = 1,
+    kSlotReady = 2,
+};
+} // namespace shm_ring
+
+// λͷλڹڴʼ
+struct ShmRingHeader {
+    char magic[8]; // ħ "VGGTRNG1"
+    std::uint32_t version; // Э汾
+    std::uint32_t slot_count; // λ
+    std::uint32_t max_cams; // ÿλɵӽ
+    std::uint32_t height; // ֡߶
+    std::uint32_t width; // ֡
+    std::uint32_t channels; // ͨ
+    std::uint64_t slot_stride; // ڲλֽڼ
+    std::uint64_t frame_stride; // λֽ֡ڼ
+    std::uint64_t slot_header_bytes; // λʼһ֡ݵֽ
+    std::atomic<std::uint32_t> closed; // дѽ
+    std::uint32_t writer_pid; // д˽̺
+    std::atomic<std::uint64_t> write_seq; // ѷ
+    std::atomic<std::uint64_t> read_seq; // ͷŵ
+    std::atomic<std::uint32_t> reader_pid; // Ӷ˵Ľ̺ţ0 ʾûж
+};
+
+// λͷ cam_ids[max_cams]int32
+struct ShmSlotHeader {
+    std::atomic<std::uint64_t> seq; // λǰݵ
+    std::atomic<std::uint32_t> state; // shm_ring::SlotState
+    std::uint32_t cam_count; // ӽ
+    std::int64_t frame_index; // ֡
+    double timestamp; // ʱ
+};
+
+// λĳߴ
+struct ShmRingLayout {
+    std::uint32_t slot_count = 8; // λ
+    std::uint32_t max_cams = 0; // ÿλɵӽ
+    std::uint32_t width = 0; // ֡
+    std::uint32_t height = 0; // ֡߶
+    std::uint32_t channels = 3; // ͨ
+};
+
+// дˣڴ沢򷢲Σʱǹرղɾڴ֣ӳĶ˲Ӱ죩
+class ShmFrameRingWriter {
+public:
+    ShmFrameRingWriter() = default;
+    ShmFrameRingWriter(const ShmFrameRingWriter&) = delete;
+    ShmFrameRingWriter& operator=(const ShmFrameRingWriter&) = delete;
+    ~ShmFrameRingWriter();
+
+    // name  "/vggt_frames"
+    bool create(const std::string& name, const ShmRingLayout& layout);
+    // οһλλȫռʱжȴ timeout˿סʱ
+    // ûжʱһֱȵӣdrop_without_reader Ϊ true ʱΪ false
+    bool publish(const FrameBatch& batch, std::chrono::milliseconds timeout,
+                 bool drop_without_reader = false);
+    void close();
+
+    bool is_open() const noexcept { return header_ != nullptr; }
+    // ǰǷдĶ
+    bool reader_attached() const;
+    std::uint64_t published() const noexcept { return next_seq_; }
+
+private:
+    std::string name_; // ڴ
+    void* base_ = nullptr; // ӳʼַ
+    std::size_t bytes_ = 0; // ӳֽ
+    ShmRingHeader* header_ = nullptr; // ͷ
+    std::uint64_t next_seq_ = 0; // һ
+    bool waiting_for_reader_ = false; // ڵȴӣֻʾһΣ
+};
+
+// ˿һΣframes е Mat ֱָڴ棬release ǰЧ
+struct ShmBatchView {
+    std::uint64_t seq = 0; // 
+    FrameBatch batch; // 㿽֡
+};
+
+// ˣӳеĹڴ棬ȡ
+class ShmFrameRingReader {
+public:
+    ShmFrameRingReader() = default;
+    ShmFrameRingReader(const ShmFrameRingReader&) = delete;
+    ShmFrameRingReader& operator=(const ShmFrameRingReader&) = delete;
+    ~ShmFrameRingReader();
+
+    // ӳ乲ڴ沢ǼΪˣдĶʱʧܣЭ飩
+    bool open(const std::string& name);
+    // ȴһΣʱдѹرûʣʱؿ
+    std::optional<ShmBatchView> acquire(std::chrono::milliseconds timeout);
+    // 黹λ֮ view е Mat Ч
+    void release(const ShmBatchView& view);
+    void close();
+
+private:
+    void* base_ = nullptr; // ӳʼַ
+    std::size_t bytes_ = 0; // ӳֽ
+    ShmRingHeader* header_ = nullptr; // ͷ
+    std::uint64_t next_seq_ = 0; // һȡ
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <thread>
+#include <vector>
+
+// һӽԲοӽǵͬƫ
+struct CameraOffset {
+    double offset_ms = 0.0; // ͬһʱڸӽƵеʱȥڲοӽƵеʱ䣨룩
+    double confidence = 0.0; // һطֵ0~1ԽԽɿ
+};
+
+// cam_id -> ƫƣοӽǵƫΪ 0
+using SyncOffsets = std::map<int, CameraOffset>;
+
+// дƫļCSVcam_id,offset_ms,confidence
+bool save_sync_offsets(const std::filesystem::path& path, const SyncOffsets& offsets);
+bool load_sync_offsets(const std::filesystem::path& path, SyncOffsets& offsets);
+
+// תΪ ExtractOptions::camera_offsets_ms
+std::map<int, double> offsets_in_ms(const SyncOffsets& offsets);
+
+// ѡοӽǣusable[i] Ϊұŵ reference_cam ӽǣһӽǡ
+// ûпӽʱ cam_ids.size()
+std::size_t choose_reference(const std::vector<int>& cam_ids, const std::vector<char>& usable,
+                             int reference_cam);
+
+// ӽǲִ task(i)ȫɺ󷵻ء·뻥ÿ·һ̡߳
+template <typename Task>
+void run_per_camera(std::size_t count, Task task) {
+    std::vector<std::thread> workers;
+    workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers.emplace_back(task, i);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+//  FFT ع signal  reference ӳ٣ֵ߲С֣
+// signal[n + lag]  reference[n]ֻ [-max_lag, max_lag] ֵ·źȥֵ
+// źΪջûʱ false
+bool estimate_signal_lag(const std::vector<float>& reference, const std::vector<float>& signal,
+                         int max_lag, double& lag, double& confidence);
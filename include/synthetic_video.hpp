@@ -0,0 +1,30 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+
+// ϳɶλƵӽͬһƽƵ
+// ֻɲӾκλɵĽͬ
+struct SyntheticVideoOptions {
+    int cameras = 4; // ӽ cam_0 ... cam_{N-1}
+    int width = 1280; // ֱ
+    int height = 720;
+    double fps = 30.0; // ֡
+    double duration_seconds = 10.0; // ʱ
+    std::string fourcc = "MJPG"; //  FourCC MJPGmp4vavc1
+    std::string extension = ".avi"; // չƥ䣨avc1  .mp4
+    int gop = 0; // ؼ֡֡0 ʾĬϣͨ OPENCV_FFMPEG_WRITER_OPTIONS  FFmpeg
+    std::map<int, double> start_offsets_ms; // ӽǵʼƫƣ룬ͬ sync_offsets.hppȱʡΪ 0
+    double flash_at_seconds = -1.0; // >=0 ʱڸóʱ̲һ⣨ 0.1 룩ͬ
+    std::set<int> short_cams; // Щӽֻд short_fraction ʱ
+    double short_fraction = 0.5;
+    std::set<int> corrupt_cams; // Щӽļвһֽڣģ𻵵
+    unsigned seed = 1; // ݵ
+};
+
+//  output_dir/cam_N/video{extension} ɲƵ parse_cam_id Լһ£
+// ʵͬƫд output_dir/ground_truth_offsets.csv estimate_sync_offsets Ľա
+bool generate_synthetic_videos(const std::filesystem::path& output_dir,
+                               const SyntheticVideoOptions& options);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "frame_batch.hpp"
+
+// ʱ䴰ڣT ʱ̵ͬΣ [T  cams] ֡
+struct FrameWindow {
+    int window_index = -1; //
+    std::vector<std::shared_ptr<const FrameBatch>> batches; //ʱУصĴڹͬһζ
+
+    bool is_valid() const noexcept { return !batches.empty(); }
+};
+
+// ڲڴص length - stride ʱ̣stride > length ʱм
+struct WindowOptions {
+    int length = 8; // ÿڰʱ T
+    int stride = 4; // ڴļ
+    bool emit_partial_tail = false; // β T ʱʱǷȱ
+};
+
+// ʱ̵ϳɻڡֻһݣ֮ͨ shared_ptr 
+// صּȲظҲء
+class TemporalWindower {
+public:
+    explicit TemporalWindower(const WindowOptions& options);
+
+    // һʱ̵Σһʱظô
+    std::optional<FrameWindow> push(FrameBatch batch);
+    // ʱã emit_partial_tail ʣĲȱ
+    std::optional<FrameWindow> flush();
+
+private:
+    FrameWindow make_window();
+
+    WindowOptions options_; // ڲ
+    std::deque<std::shared_ptr<const FrameBatch>> pending_; // ǰռ
+    int fresh_ = 0; // pending_ δκδ
+    int skip_ = 0; // stride > length ʱ趪
+    int next_window_ = 0; // һ
+};
+
+// ڻ׶Σ input ȡΣϳɴ͵ outputر output
+// output ߹رʱͬʱر inputֹͣ롣
+void window_frames(BlockingQueue<FrameBatch>& input, BlockingQueue<FrameWindow>& output,
+                   const WindowOptions& options);
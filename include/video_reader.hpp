@@ -10,6 +10,8 @@
 #include <string>
 #include <vector>
 
+#include "video_source.hpp"
+
 // Ƶȡṹ
 struct VideoReadTask {
     std::string src; // ƵԴ·
@@ -40,7 +42,8 @@ private:
     size_t total_tasks_ = 0; // 
 };
 
-void video_read_thread(VideoTaskManager& task_manager);
+void video_read_thread(VideoTaskManager& task_manager,
+                       const VideoSourceOptions& source_options = {});
 
 std::vector<VideoReadTask> collect_video_tasks(const std::filesystem::path& input_dir,
                                                const std::filesystem::path& output_dir);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+#include <opencv2/core.hpp>
+
+// 
+enum class VideoBackend {
+    OpenCV, // cv::VideoCaptureĬ
+    LibAV, // ֱӵ FFmpeg libavcodec VGGT_WITH_LIBAV 룩
+};
+
+// ƵԴĲOpenCV ֻ֧ decoder_threads  output_width
+// ѡҪ LibAV ˲õ
+struct VideoSourceOptions {
+    VideoBackend backend = VideoBackend::OpenCV; // 
+    int decoder_threads = 0; // ߳0 ʾɽԶ
+    bool frame_threads = true; // ̣֡߳¸ߣӳٶ༸֡
+    bool slice_threads = true; // Ƭ߳
+    int output_width = 0; // >0 ʱȱСÿȵ֡
+    int lowres = 0; // ڲ1=1/2, 2=1/4, 3=1/8ֱʽ֧
+    bool skip_loop_filter = false; // ·˲Խ죬ʺϷ
+    bool skip_nonref = false; // ǲο֡֡֡Ų
+    bool native_yuv = false; // ԭ I420CV_8UC1߶Ϊ H*3/2תΪ BGR
+    // ļ I/O file_access.hpp POSIX·ƵڻеӲϽȡʱʹ
+    std::size_t readahead_bytes = 0; // >0 ʱڶȡλǰָôСԤPOSIX_FADV_WILLNEED
+    bool drop_behind = false; // ݴҳ涪POSIX_FADV_DONTNEEDת治ռ
+    std::size_t io_buffer_bytes = 0; // LibAV>0 ʱøôСҳȡĻжȡļ˳ʾ
+};
+
+// ƵԴ˳һ·Ƶ
+class VideoSource {
+public:
+    virtual ~VideoSource() = default;
+
+    // 벢һ֡frame ߴ硢Ͳʱڴ
+    virtual bool read(cv::Mat& frame) = 0;
+    // һ֡ʡȥɫת뿽
+    virtual bool grab() = 0;
+    // λԴ֡ frame_index ʵ䵽֡ţ֮ read/grab Ӹ֡ʼʧܷ -1
+    // ٱʽ޷ȷλʵ֡ŰʱȷԽ𻵵ݣʧʱԴλòȷ
+    virtual std::int64_t seek(std::int64_t frame_index) = 0;
+
+    virtual double fps() const = 0;
+    virtual int width() const = 0; // ֡
+    virtual int height() const = 0; // ֡߶
+    virtual std::int64_t frame_count() const = 0; // ֡δ֪ʱ <= 0
+    virtual bool outputs_yuv() const = 0; // read  I420  BGR
+    virtual const char* backend_name() const = 0;
+};
+
+//  options.backend ƵԴʧܷ nullptr
+//  LibAV ˵δʱ˵ OpenCV ˡ
+std::unique_ptr<VideoSource> open_video_source(const std::filesystem::path& path,
+                                               const VideoSourceOptions& options = {});
+
+#ifdef VGGT_WITH_LIBAV
+std::unique_ptr<VideoSource> open_libav_source(const std::filesystem::path& path,
+                                               const VideoSourceOptions& options);
+#endif
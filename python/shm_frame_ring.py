@@ -0,0 +1,129 @@
+"""共享内存同步帧环形缓冲区的 Python 读端。
+
+协议与内存布局见 include/shm_frame_ring.hpp。帧以 numpy 视图的形式直接指向共享内存，
+在调用 release() 之前有效；需要长期保存时请自行 copy()。
+"""
+
+import ctypes
+import ctypes.util
+import os
+import time
+from multiprocessing import resource_tracker, shared_memory
+
+import numpy as np
+
+_MAGIC = b"VGGTRNG1"
+_VERSION = 2
+_HEADER_BYTES = 128
+_SLOT_READY = 2
+_SLOT_EMPTY = 0
+_ATOMIC_SEQ_CST = 5  # __ATOMIC_SEQ_CST
+_cas_u32 = None  # libatomic 的 __atomic_compare_exchange_4，首次使用时加载
+
+
+def _compare_exchange_u32(target, expected, desired):
+    """对共享内存中的 uint32 做原子比较交换（与 C++ 端的 std::atomic 兼容），返回 (成功, 原值)。"""
+    global _cas_u32
+    if _cas_u32 is None:
+        name = ctypes.util.find_library("atomic")
+        if name is None:
+            raise RuntimeError("找不到 libatomic，无法原子地登记读端")
+        _cas_u32 = ctypes.CDLL(name).__atomic_compare_exchange_4
+        _cas_u32.restype = ctypes.c_bool
+        _cas_u32.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_int, ctypes.c_int]
+    current = ctypes.c_uint32(expected)
+    ok = _cas_u32(ctypes.addressof(target), ctypes.byref(current), desired, _ATOMIC_SEQ_CST, _ATOMIC_SEQ_CST)
+    return ok, current.value
+
+
+def _process_alive(pid):
+    if pid == 0:
+        return False
+    try:
+        os.kill(pid, 0)
+    except PermissionError:
+        return True
+    except OSError:
+        return False
+    return True
+
+
+class ShmFrameRingReader:
+    def __init__(self, name):
+        # 写端使用 "/vggt_frames" 形式的名字，Python 端不带前导斜杠
+        self._shm = shared_memory.SharedMemory(name=name.lstrip("/"), create=False)
+        # 共享内存归写端所有，避免 resource_tracker 在读端退出时将其删除
+        resource_tracker.unregister(self._shm._name, "shared_memory")
+        buf = self._shm.buf
+        if bytes(buf[0:8]) != _MAGIC:
+            raise ValueError("共享内存协议不匹配: %s" % name)
+        u32 = np.frombuffer(buf, dtype="<u4", count=8, offset=8)
+        u64 = np.frombuffer(buf, dtype="<u8", count=3, offset=32)
+        if int(u32[0]) != _VERSION:
+            raise ValueError("共享内存协议版本不匹配: %d" % int(u32[0]))
+        self.slot_count, self.max_cams, self.height, self.width, self.channels = (int(v) for v in u32[1:6])
+        self.slot_stride, self.frame_stride, self.slot_header_bytes = (int(v) for v in u64)
+        del u32, u64  # 临时视图同样持有缓冲区导出
+        self._closed = np.frombuffer(buf, dtype="<u4", count=1, offset=56)
+        self._seqs = np.frombuffer(buf, dtype="<u8", count=2, offset=64)  # write_seq, read_seq
+        # 用 CAS 登记为读端（单读端协议），上一个读端已退出时接替它；两个读端同时连接只有一个成功
+        self._reader_pid = ctypes.c_uint32.from_buffer(buf, 80)
+        pid = os.getpid()
+        attached = self._reader_pid.value
+        while attached != pid:
+            if _process_alive(attached):
+                self._release_buffer()
+                raise RuntimeError("共享内存 %s 已有读端进程 %d" % (name, attached))
+            ok, attached = _compare_exchange_u32(self._reader_pid, attached, pid)
+            if ok:
+                break
+        self._next_seq = int(self._seqs[1])
+
+    def _slot_offset(self, seq):
+        return _HEADER_BYTES + (seq % self.slot_count) * self.slot_stride
+
+    def acquire(self, timeout=1.0):
+        """等待下一个批次，返回 (seq, frame_index, timestamp, {cam_id: ndarray[H, W, C]})。
+
+        超时或写端已关闭且没有剩余批次时返回 None。
+        """
+        deadline = time.monotonic() + timeout
+        while int(self._seqs[0]) <= self._next_seq:
+            if int(self._closed[0]) != 0 or time.monotonic() >= deadline:
+                return None
+            time.sleep(0.0002)
+
+        seq = self._next_seq
+        base = self._slot_offset(seq)
+        buf = self._shm.buf
+        slot_seq = int(np.frombuffer(buf, dtype="<u8", count=1, offset=base)[0])
+        state, cam_count = np.frombuffer(buf, dtype="<u4", count=2, offset=base + 8)
+        if state != _SLOT_READY or slot_seq != seq:
+            raise RuntimeError("共享内存槽位序号不一致: %d" % seq)
+        frame_index = int(np.frombuffer(buf, dtype="<i8", count=1, offset=base + 16)[0])
+        timestamp = float(np.frombuffer(buf, dtype="<f8", count=1, offset=base + 24)[0])
+        cam_ids = np.frombuffer(buf, dtype="<i4", count=int(cam_count), offset=base + 32)
+
+        frames = {}
+        shape = (self.height, self.width, self.channels)
+        for i, cam_id in enumerate(cam_ids):
+            offset = base + self.slot_header_bytes + i * self.frame_stride
+            frames[int(cam_id)] = np.ndarray(shape, dtype=np.uint8, buffer=buf, offset=offset)
+        self._next_seq += 1
+        return seq, frame_index, timestamp, frames
+
+    def release(self, seq):
+        """归还槽位，之后该批次的数组不再有效。"""
+        base = self._slot_offset(seq)
+        np.frombuffer(self._shm.buf, dtype="<u4", count=1, offset=base + 8)[0] = _SLOT_EMPTY
+        self._seqs[1] = seq + 1
+
+    def _release_buffer(self):
+        # ctypes 对象持有共享内存缓冲区的导出，须先释放才能关闭
+        self._closed = self._seqs = self._reader_pid = None
+        self._shm.close()
+
+    def close(self):
+        if self._reader_pid is not None:
+            _compare_exchange_u32(self._reader_pid, os.getpid(), 0)
+        self._release_buffer()
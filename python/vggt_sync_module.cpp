@@ -0,0 +1,372 @@
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "batch_tensor.hpp"
+#include "frame_batch.hpp"
+#include "frame_extractor.hpp"
+#include "frame_format.hpp"
+#include "temporal_window.hpp"
+#ifdef VGGT_WITH_DLPACK
+#include "dlpack_export.hpp"
+#endif
+
+namespace py = pybind11;
+
+//  Python ַĵ쳣Ϣ UTF-8ͳһʹ ASCII
+
+namespace {
+//  Mat װɹͬһڴ numpy 顣
+// capsule һ Mat ͷüڼزᱻͷš
+py::array mat_to_array(const cv::Mat& mat) {
+    py::dtype dtype;
+    switch (mat.depth()) {
+    case CV_8U:
+        dtype = py::dtype::of<std::uint8_t>();
+        break;
+    case CV_16U:
+        dtype = py::dtype::of<std::uint16_t>();
+        break;
+    case CV_32F:
+        dtype = py::dtype::of<float>();
+        break;
+    default:
+        throw py::type_error("unsupported frame depth");
+    }
+
+    auto* owner = new cv::Mat(mat);
+    py::capsule base(owner, [](void* ptr) { delete static_cast<cv::Mat*>(ptr); });
+    std::vector<py::ssize_t> shape = {mat.rows, mat.cols};
+    std::vector<py::ssize_t> strides = {static_cast<py::ssize_t>(mat.step[0]),
+                                        static_cast<py::ssize_t>(mat.elemSize())};
+    if (mat.channels() > 1) {
+        shape.push_back(mat.channels());
+        strides.push_back(static_cast<py::ssize_t>(mat.elemSize1()));
+    }
+    return py::array(dtype, shape, strides, owner->data, base);
+}
+
+// ģڹأPyTorch ͷ󻺳ص
+std::shared_ptr<TensorBufferPool> tensor_pool() {
+    static auto pool = std::make_shared<TensorBufferPool>();
+    return pool;
+}
+
+#ifdef VGGT_WITH_DLPACK
+//  DLPack Python ԼװΪΪ "dltensor"  capsule
+// ѷȡߺΪ "used_dltensor"ʱѷ deleter
+py::capsule dlpack_capsule(const BatchTensor& tensor) {
+    DLManagedTensor* managed = to_dlpack(tensor);
+    if (managed == nullptr) {
+        throw py::value_error("invalid tensor");
+    }
+    PyObject* capsule = PyCapsule_New(managed, "dltensor", [](PyObject* obj) {
+        if (PyCapsule_IsValid(obj, "dltensor")) {
+            auto* unused = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(obj, "dltensor"));
+            unused->deleter(unused);
+        }
+    });
+    if (capsule == nullptr) {
+        managed->deleter(managed);
+        throw py::error_already_set();
+    }
+    return py::reinterpret_steal<py::capsule>(capsule);
+}
+#endif
+
+// ̵̨߳Ľ״̬߳ݳ쳣ᾭ std::terminate  Python ̣
+// ¼¼쳣ʧܣȡպ __next__ ׸ Python
+class WorkerStatus {
+public:
+    void set_exception(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) {
+            error_ = std::move(error);
+        }
+    }
+
+    void set_failed(const char* message) {
+        set_exception(std::make_exception_ptr(std::runtime_error(message)));
+    }
+
+    // дʱ׳һΣpybind11  C++ 쳣תΪӦ Python 쳣֮
+    void rethrow() {
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error = std::move(error_);
+            error_ = nullptr;
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::exception_ptr error_;
+};
+
+// ں̨߳ extract_frames_single쳣ʧܼ statusܻᱻر
+void run_extractor(const std::filesystem::path& input_dir, BlockingQueue<FrameBatch>& queue,
+                   const ExtractOptions& options, WorkerStatus& status) {
+    try {
+        if (!extract_frames_single(input_dir, queue, options)) {
+            status.set_failed("frame extraction failed (see stderr for details)");
+        }
+    } catch (...) {
+        status.set_exception(std::current_exception());
+        queue.close();
+    }
+}
+
+// ں̨߳ extract_frames_singlePython ˰ε
+// ȴʱͷ GIL Python ദнС
+class BatchIterator {
+public:
+    BatchIterator(const std::string& input_dir, const ExtractOptions& options,
+                  std::size_t queue_capacity)
+        : queue_(queue_capacity),
+          worker_(run_extractor, std::filesystem::path(input_dir), std::ref(queue_), options,
+                  std::ref(status_)) {}
+
+    ~BatchIterator() { stop(); }
+
+    FrameBatch next() {
+        std::optional<FrameBatch> batch;
+        {
+            py::gil_scoped_release release;
+            batch = queue_.pop();
+        }
+        if (!batch) {
+            // ̳߳ʱӵȡ׳ǵ
+            status_.rethrow();
+            throw py::stop_iteration();
+        }
+        return std::move(*batch);
+    }
+
+    // رնý߳̾˳ڽһ֡ɺ߳̽
+    void stop() {
+        queue_.close();
+        if (worker_.joinable()) {
+            py::gil_scoped_release release;
+            worker_.join();
+        }
+    }
+
+    std::size_t pending() const { return queue_.size(); }
+
+private:
+    BlockingQueue<FrameBatch> queue_; // ߳ Python ֮н
+    WorkerStatus status_; // ̵߳쳣ʧܣ߳ǰ
+    std::thread worker_; // ߳
+};
+
+//  BatchIterator ĻӴڻ̣߳Python ˰ [T  cams] ڵ
+class WindowIterator {
+public:
+    WindowIterator(const std::string& input_dir, const ExtractOptions& extract_options,
+                   const WindowOptions& options, std::size_t queue_capacity)
+        : batches_(queue_capacity),
+          windows_(queue_capacity),
+          extractor_(run_extractor, std::filesystem::path(input_dir), std::ref(batches_),
+                     extract_options, std::ref(status_)),
+          windower_([this, options]() {
+              try {
+                  window_frames(batches_, windows_, options);
+              } catch (...) {
+                  status_.set_exception(std::current_exception());
+                  // ߳̿ batches_ 
+                  batches_.close();
+                  windows_.close();
+              }
+          }) {}
+
+    ~WindowIterator() { stop(); }
+
+    FrameWindow next() {
+        std::optional<FrameWindow> window;
+        {
+            py::gil_scoped_release release;
+            window = windows_.pop();
+        }
+        if (!window) {
+            status_.rethrow();
+            throw py::stop_iteration();
+        }
+        return std::move(*window);
+    }
+
+    void stop() {
+        windows_.close();
+        batches_.close();
+        py::gil_scoped_release release;
+        if (windower_.joinable()) {
+            windower_.join();
+        }
+        if (extractor_.joinable()) {
+            extractor_.join();
+        }
+    }
+
+private:
+    BlockingQueue<FrameBatch> batches_; // ߳ -> ڻ߳
+    BlockingQueue<FrameWindow> windows_; // ڻ߳ -> Python
+    WorkerStatus status_; // ̵̨߳쳣ʧܣ߳ǰ
+    std::thread extractor_; // ߳
+    std::thread windower_; // ڻ߳
+};
+} // namespace
+
+PYBIND11_MODULE(vggt_sync, m) {
+    m.doc() = "Synchronized multi-camera frame extraction";
+
+    py::class_<FrameBatch>(m, "FrameBatch")
+        .def_readonly("frame_index", &FrameBatch::frame_index)
+        .def_readonly("timestamp", &FrameBatch::timestamp)
+        .def_readonly("segment_id", &FrameBatch::segment_id)
+        .def_readonly("sharpness", &FrameBatch::sharpness)
+        .def_readonly("missing_cams", &FrameBatch::missing_cams)
+        .def_property_readonly("cam_ids",
+                               [](const FrameBatch& batch) {
+                                   std::vector<int> ids;
+                                   for (const auto& [cam_id, frame] : batch.frames) {
+                                       ids.push_back(cam_id);
+                                   }
+                                   return ids;
+                               })
+        .def_property_readonly("pixel_format",
+                               [](const FrameBatch& batch) {
+                                   switch (batch.pixel_format) {
+                                   case FramePixelFormat::Gray:
+                                       return "gray";
+                                   case FramePixelFormat::I420:
+                                       return "i420";
+                                   case FramePixelFormat::BGR:
+                                       break;
+                                   }
+                                   return "bgr";
+                               })
+        // {cam_id: ndarray[H, W, 3]}ײ Mat ڴ棨BGR ͨ˳򣩣
+        // I420 תΪ BGR·
+        .def_property_readonly("frames",
+                               [](const FrameBatch& batch) {
+                                   FrameBatch converted;
+                                   const FrameBatch& packed = to_bgr_batch(batch, converted);
+                                   py::dict frames;
+                                   for (const auto& [cam_id, frame] : packed.frames) {
+                                       frames[py::int_(cam_id)] = mat_to_array(frame);
+                                   }
+                                   return frames;
+                               })
+        .def("__len__", [](const FrameBatch& batch) { return batch.frames.size(); })
+        // תΪ [cams, 3, H, W] float32 RGB תڼͷ GIL
+        .def(
+            "to_tensor",
+            [](const FrameBatch& batch, int width, int size_multiple) {
+                TensorOptions options;
+                options.width = width;
+                options.size_multiple = size_multiple;
+                py::gil_scoped_release release;
+                return make_batch_tensor(batch, options, tensor_pool().get());
+            },
+            py::arg("width") = 518, py::arg("size_multiple") = 14);
+
+    py::class_<FrameWindow>(m, "FrameWindow")
+        .def_readonly("window_index", &FrameWindow::window_index)
+        // ʱе FrameBatch бصеͬһʱ̹ڴ
+        .def_property_readonly("batches",
+                               [](const FrameWindow& window) {
+                                   std::vector<FrameBatch> batches;
+                                   for (const auto& batch : window.batches) {
+                                       batches.push_back(*batch);
+                                   }
+                                   return batches;
+                               })
+        .def("__len__", [](const FrameWindow& window) { return window.batches.size(); });
+
+    py::class_<BatchTensor>(m, "BatchTensor")
+        .def_readonly("frame_index", &BatchTensor::frame_index)
+        .def_readonly("timestamp", &BatchTensor::timestamp)
+        .def_readonly("cam_ids", &BatchTensor::cam_ids)
+        .def_readonly("shape", &BatchTensor::shape)
+        .def_property_readonly("is_valid", &BatchTensor::is_valid)
+#ifdef VGGT_WITH_DLPACK
+        // torch.from_dlpack(tensor) 㿽գ PyTorch ͷźص
+        .def(
+            "__dlpack__", [](const BatchTensor& tensor, py::object) { return dlpack_capsule(tensor); },
+            py::arg("stream") = py::none())
+        .def("__dlpack_device__", [](const BatchTensor&) { return py::make_tuple(1, 0); })
+        .def("to_dlpack", &dlpack_capsule)
+#endif
+        ;
+
+    py::class_<ExtractOptions>(m, "ExtractOptions")
+        .def(py::init<>())
+        .def_readwrite("decode_width", &ExtractOptions::decode_width)
+        .def_readwrite("grayscale", &ExtractOptions::grayscale)
+        .def_readwrite("frame_step", &ExtractOptions::frame_step)
+        .def_readwrite("target_fps", &ExtractOptions::target_fps)
+        // target_fps Чʱʱǰ֡ȡһ֡
+        .def_property(
+            "blend",
+            [](const ExtractOptions& options) { return options.resample == FrameResample::Blend; },
+            [](ExtractOptions& options, bool value) {
+                options.resample = value ? FrameResample::Blend : FrameResample::Nearest;
+            })
+        // {cam_id: offset_ms} sync_offsets.csv ͬ
+        .def_readwrite("camera_offsets_ms", &ExtractOptions::camera_offsets_ms)
+        .def_property(
+            "native_yuv", [](const ExtractOptions& options) { return options.source.native_yuv; },
+            [](ExtractOptions& options, bool value) { options.source.native_yuv = value; });
+
+    py::class_<BatchIterator>(m, "BatchIterator")
+        .def(py::init<const std::string&, const ExtractOptions&, std::size_t>(), py::arg("input_dir"),
+             py::arg("options") = ExtractOptions{}, py::arg("queue_capacity") = 8)
+        .def("__iter__", [](BatchIterator& self) -> BatchIterator& { return self; })
+        .def("__next__", &BatchIterator::next)
+        .def("stop", &BatchIterator::stop)
+        .def("__enter__", [](BatchIterator& self) -> BatchIterator& { return self; })
+        .def("__exit__", [](BatchIterator& self, py::args) { self.stop(); })
+        .def_property_readonly("pending", &BatchIterator::pending);
+
+    py::class_<WindowIterator>(m, "WindowIterator")
+        .def("__iter__", [](WindowIterator& self) -> WindowIterator& { return self; })
+        .def("__next__", &WindowIterator::next)
+        .def("stop", &WindowIterator::stop)
+        .def("__enter__", [](WindowIterator& self) -> WindowIterator& { return self; })
+        .def("__exit__", [](WindowIterator& self, py::args) { self.stop(); });
+
+    m.def(
+        "extract_windows",
+        [](const std::string& input_dir, int length, int stride, bool emit_partial_tail,
+           const ExtractOptions& extract_options, std::size_t queue_capacity) {
+            WindowOptions options;
+            options.length = length;
+            options.stride = stride;
+            options.emit_partial_tail = emit_partial_tail;
+            return std::make_unique<WindowIterator>(input_dir, extract_options, options,
+                                                    queue_capacity);
+        },
+        py::arg("input_dir"), py::arg("length") = 8, py::arg("stride") = 4,
+        py::arg("emit_partial_tail") = false, py::arg("options") = ExtractOptions{},
+        py::arg("queue_capacity") = 8,
+        "Iterate sliding windows of `length` consecutive FrameBatch objects, `stride` apart");
+
+    m.def(
+        "extract_frames",
+        [](const std::string& input_dir, const ExtractOptions& options, std::size_t queue_capacity) {
+            return std::make_unique<BatchIterator>(input_dir, options, queue_capacity);
+        },
+        py::arg("input_dir"), py::arg("options") = ExtractOptions{}, py::arg("queue_capacity") = 8,
+        "Iterate synchronized FrameBatch objects decoded from the videos under input_dir");
+}
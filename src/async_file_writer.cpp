@@ -0,0 +1,297 @@
+#include "async_file_writer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+#include "pipeline_metrics.hpp"
+#include "pipeline_trace.hpp"
+
+#ifdef VGGT_WITH_LIBURING
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <liburing.h>
+#endif
+
+#ifdef VGGT_WITH_LIBURING
+// ÿ;ļռһעļλopen/write/close һύ
+// ļֻں˵עļУ̵ fd 
+struct AsyncFileWriter::UringState {
+    struct Slot {
+        FileWriteJob job;
+        int pending = 0; // δɵ
+        bool failed = false; // ʧܻд벻
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    io_uring ring{};
+    bool initialized = false;
+    std::vector<Slot> slots;
+    std::vector<unsigned> free_slots;
+
+    ~UringState() {
+        if (initialized) {
+            io_uring_queue_exit(&ring);
+        }
+    }
+};
+#else
+struct AsyncFileWriter::UringState {};
+#endif
+
+#ifdef VGGT_WITH_LIBURING
+namespace {
+// user_data = λ * 3 + 
+constexpr unsigned kOpenOp = 0;
+constexpr unsigned kWriteOp = 1;
+constexpr unsigned kCloseOp = 2;
+constexpr unsigned kOpsPerFile = 3;
+} // namespace
+#endif
+
+AsyncFileWriter::AsyncFileWriter(const AsyncWriterOptions& options)
+    : options_(options), jobs_(std::max<std::size_t>(options.max_pending, 1)) {
+#ifdef VGGT_WITH_LIBURING
+    if (options_.backend == AsyncWriteBackend::IoUring) {
+        uring_ = start_uring();
+    }
+#else
+    if (options_.backend == AsyncWriteBackend::IoUring) {
+        std::cerr << "δ io_uring ֱ֧루VGGT_WITH_LIBURING̳߳д" << std::endl;
+    }
+#endif
+    if (!uring_) {
+        const int threads = std::max(options_.threads, 1);
+        for (int i = 0; i < threads; ++i) {
+            workers_.emplace_back(&AsyncFileWriter::run_thread_pool, this);
+        }
+    }
+}
+
+AsyncFileWriter::~AsyncFileWriter() { close(); }
+
+bool AsyncFileWriter::write(std::filesystem::path path, std::vector<unsigned char> data,
+                            std::shared_ptr<MemoryReservation> reservation) {
+    FileWriteJob job;
+    job.reservation = std::move(reservation);
+    job.path = std::move(path);
+    job.data = std::move(data);
+    return jobs_.push(std::move(job));
+}
+
+void AsyncFileWriter::close() {
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    jobs_.close();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+const char* AsyncFileWriter::backend_name() const noexcept {
+    return uring_ ? "io_uring" : "thread_pool";
+}
+
+bool AsyncFileWriter::write_sync(const FileWriteJob& job) {
+    std::ofstream out(job.path, std::ios::binary | std::ios::trunc);
+    if (out) {
+        out.write(reinterpret_cast<const char*>(job.data.data()),
+                  static_cast<std::streamsize>(job.data.size()));
+        out.close();
+    }
+    if (!out) {
+        std::cerr << "дļʧ: " << job.path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void AsyncFileWriter::finish(const FileWriteJob& job, bool ok) {
+    if (ok) {
+        files_written_.fetch_add(1, std::memory_order_relaxed);
+        bytes_written_.fetch_add(job.data.size(), std::memory_order_relaxed);
+    } else {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AsyncFileWriter::run_thread_pool() {
+    pipeline_tracer().name_thread("file_writer");
+    StageMetrics* const write_metrics = pipeline_metrics().stage("file_write");
+    while (std::optional<FileWriteJob> job = jobs_.pop()) {
+        bool ok = false;
+        {
+            StageTimer timer(write_metrics);
+            TraceSpan span("file_write");
+            ok = write_sync(*job);
+            if (ok) {
+                timer.set_bytes(job->data.size());
+            }
+        }
+        finish(*job, ok);
+    }
+}
+
+#ifdef VGGT_WITH_LIBURING
+bool AsyncFileWriter::start_uring() {
+    auto state = std::make_unique<UringState>();
+    const unsigned slot_count = static_cast<unsigned>(std::max(options_.in_flight, 1));
+    int ret = io_uring_queue_init(slot_count * kOpsPerFile, &state->ring, 0);
+    if (ret < 0) {
+        std::cerr << "io_uring ʼʧ: " << std::strerror(-ret) << "̳߳д" << std::endl;
+        return false;
+    }
+    state->initialized = true;
+    // ϡעļҪ Linux 5.19+
+    ret = io_uring_register_files_sparse(&state->ring, slot_count);
+    if (ret < 0) {
+        std::cerr << "io_uring עļʧ: " << std::strerror(-ret) << "̳߳д"
+                  << std::endl;
+        return false;
+    }
+    state->slots.resize(slot_count);
+    for (unsigned i = slot_count; i > 0; --i) {
+        state->free_slots.push_back(i - 1);
+    }
+    uring_state_ = std::move(state);
+    workers_.emplace_back(&AsyncFileWriter::run_uring, this);
+    return true;
+}
+
+void AsyncFileWriter::run_uring() {
+    pipeline_tracer().name_thread("file_writer io_uring");
+    StageMetrics* const write_metrics = pipeline_metrics().stage("file_write");
+    UringState& state = *uring_state_;
+    std::size_t in_flight = 0;
+
+    auto complete = [&](unsigned slot_index) {
+        UringState::Slot& slot = state.slots[slot_index];
+        // ʧܵļͬдһΣͬʱĴ
+        const bool ok = !slot.failed || write_sync(slot.job);
+        if (write_metrics) {
+            const auto elapsed = std::chrono::steady_clock::now() - slot.submitted;
+            write_metrics->add(static_cast<std::uint64_t>(
+                                   std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                               ok ? slot.job.data.size() : 0);
+        }
+        finish(slot.job, ok);
+        slot.job = FileWriteJob{};
+        slot.failed = false;
+        state.free_slots.push_back(slot_index);
+        --in_flight;
+    };
+    // һ¼λϵɺļ
+    auto reap = [&](const io_uring_cqe& cqe) {
+        const auto user_data = io_uring_cqe_get_data64(&cqe);
+        const auto slot_index = static_cast<unsigned>(user_data / kOpsPerFile);
+        UringState::Slot& slot = state.slots[slot_index];
+        if (cqe.res < 0 ||
+            (user_data % kOpsPerFile == kWriteOp &&
+             static_cast<std::size_t>(cqe.res) != slot.job.data.size())) {
+            slot.failed = true;
+        }
+        if (--slot.pending == 0) {
+            complete(slot_index);
+        }
+    };
+    bool submit_failed = false;
+
+    while (true) {
+        // Ŷӵļвλһύû;ļʱȴļ
+        while (!state.free_slots.empty()) {
+            std::optional<FileWriteJob> job = in_flight == 0 ? jobs_.pop() : jobs_.try_pop();
+            if (!job) {
+                break;
+            }
+            const unsigned slot_index = state.free_slots.back();
+            state.free_slots.pop_back();
+            UringState::Slot& slot = state.slots[slot_index];
+            slot.job = std::move(*job);
+            slot.pending = kOpsPerFile;
+            slot.submitted = std::chrono::steady_clock::now();
+
+            // SQ λ  3 һȡõ
+            io_uring_sqe* sqe = io_uring_get_sqe(&state.ring);
+            io_uring_prep_openat_direct(sqe, AT_FDCWD, slot.job.path.c_str(),
+                                        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644, slot_index);
+            sqe->flags |= IOSQE_IO_LINK;
+            io_uring_sqe_set_data64(sqe, slot_index * kOpsPerFile + kOpenOp);
+
+            sqe = io_uring_get_sqe(&state.ring);
+            io_uring_prep_write(sqe, static_cast<int>(slot_index), slot.job.data.data(),
+                                static_cast<unsigned>(slot.job.data.size()), 0);
+            // дʧҲҪرղλӲӱ֤ close ִ
+            sqe->flags |= IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+            io_uring_sqe_set_data64(sqe, slot_index * kOpsPerFile + kWriteOp);
+
+            sqe = io_uring_get_sqe(&state.ring);
+            io_uring_prep_close_direct(sqe, slot_index);
+            io_uring_sqe_set_data64(sqe, slot_index * kOpsPerFile + kCloseOp);
+            ++in_flight;
+        }
+        if (in_flight == 0) {
+            break; // ѹرȫд
+        }
+
+        const int ret = io_uring_submit_and_wait(&state.ring, 1);
+        if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+            std::cerr << "io_uring ύʧ: " << std::strerror(-ret) << "Ϊͬд" << std::endl;
+            submit_failed = true;
+            break;
+        }
+
+        io_uring_cqe* cqe = nullptr;
+        unsigned head = 0;
+        unsigned seen = 0;
+        io_uring_for_each_cqe(&state.ring, head, cqe) {
+            ++seen;
+            reap(*cqe);
+        }
+        io_uring_cq_advance(&state.ring, seen);
+    }
+
+    // ںδɵ
+    std::size_t accepted = 0;
+    if (submit_failed) {
+        // ںڶλĻдͬһļȵȫɣ
+        // ͬд SQ δ֮󲻻ύ¼
+        for (const auto& slot : state.slots) {
+            accepted += static_cast<std::size_t>(slot.pending);
+        }
+        accepted -= std::min<std::size_t>(accepted, io_uring_sq_ready(&state.ring));
+        while (accepted > 0) {
+            io_uring_cqe* cqe = nullptr;
+            const int ret = io_uring_wait_cqe(&state.ring, &cqe);
+            if (ret == -EINTR) {
+                continue;
+            }
+            if (ret < 0) {
+                // λĻдںԿܶȡʱͷ
+                std::cerr << "io_uring ȴ¼ʧ: " << std::strerror(-ret) << std::endl;
+                break;
+            }
+            reap(*cqe);
+            io_uring_cqe_seen(&state.ring, cqe);
+            --accepted;
+        }
+    }
+    // δںļʣŶӵļȫͬд
+    for (auto& slot : state.slots) {
+        if (slot.pending > 0) {
+            finish(slot.job, write_sync(slot.job));
+            slot.pending = 0;
+            if (accepted == 0) {
+                slot.job = FileWriteJob{}; // ں˲ã黹ڴԤ
+            }
+        }
+    }
+    while (std::optional<FileWriteJob> job = jobs_.pop()) {
+        finish(*job, write_sync(*job));
+    }
+}
+#endif
@@ -0,0 +1,129 @@
+#include "audio_sync.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+namespace {
+// ĲʣʵʲԽΪ׼ٽ
+constexpr int kDecodeSampleRate = 16000;
+} // namespace
+
+bool decode_audio_track(const std::filesystem::path& path, const AudioSyncOptions& options,
+                        std::vector<float>& samples) {
+    samples.clear();
+    const std::vector<int> params = {cv::CAP_PROP_AUDIO_STREAM, 0,
+                                     cv::CAP_PROP_VIDEO_STREAM, -1,
+                                     cv::CAP_PROP_AUDIO_DATA_DEPTH, CV_32F,
+                                     cv::CAP_PROP_AUDIO_SAMPLES_PER_SECOND, kDecodeSampleRate};
+    cv::VideoCapture capture(path.string(), cv::CAP_ANY, params);
+    if (!capture.isOpened()) {
+        std::cerr << "޷: " << path << std::endl;
+        return false;
+    }
+    const int base_index = static_cast<int>(capture.get(cv::CAP_PROP_AUDIO_BASE_INDEX));
+    const int channels = static_cast<int>(capture.get(cv::CAP_PROP_AUDIO_TOTAL_CHANNELS));
+    const double decode_rate = capture.get(cv::CAP_PROP_AUDIO_SAMPLES_PER_SECOND);
+    if (channels <= 0 || decode_rate <= 0.0) {
+        std::cerr << "Ƶûпɽ: " << path << std::endl;
+        return false;
+    }
+
+    // ۼΪ
+    const std::size_t max_samples = static_cast<std::size_t>(options.analysis_seconds * decode_rate);
+    std::vector<float> decoded;
+    decoded.reserve(max_samples);
+    cv::Mat chunk;
+    cv::Mat mono;
+    while (decoded.size() < max_samples && capture.grab()) {
+        bool mixed = false;
+        for (int c = 0; c < channels; ++c) {
+            if (!capture.retrieve(chunk, base_index + c) || chunk.empty()) {
+                break;
+            }
+            if (c == 0) {
+                chunk.convertTo(mono, CV_32F, 1.0 / channels);
+                mixed = true;
+            } else if (chunk.total() == mono.total()) {
+                cv::Mat scaled;
+                chunk.convertTo(scaled, CV_32F, 1.0 / channels);
+                cv::add(mono, scaled, mono);
+            }
+        }
+        if (!mixed) {
+            continue;
+        }
+        const float* values = mono.ptr<float>();
+        decoded.insert(decoded.end(), values, values + mono.total());
+    }
+    if (decoded.empty()) {
+        std::cerr << "Ϊ: " << path << std::endl;
+        return false;
+    }
+    decoded.resize(std::min(decoded.size(), max_samples));
+
+    // ֵֿƽͬʱ𵽿ͨ
+    const int target = std::max(
+        1, static_cast<int>(std::lround(decoded.size() * options.sample_rate / decode_rate)));
+    if (target >= static_cast<int>(decoded.size())) {
+        samples = std::move(decoded);
+        return true;
+    }
+    const cv::Mat source(1, static_cast<int>(decoded.size()), CV_32F, decoded.data());
+    samples.resize(target);
+    cv::Mat resampled(1, target, CV_32F, samples.data());
+    cv::resize(source, resampled, resampled.size(), 0, 0, cv::INTER_AREA);
+    return true;
+}
+
+SyncOffsets estimate_audio_offsets(const std::vector<CameraVideo>& videos,
+                                   const AudioSyncOptions& options) {
+    SyncOffsets offsets;
+    std::vector<std::vector<float>> tracks(videos.size());
+    std::vector<char> decoded(videos.size(), 0);
+    run_per_camera(videos.size(), [&](std::size_t i) {
+        decoded[i] = decode_audio_track(videos[i].path, options, tracks[i]) ? 1 : 0;
+    });
+
+    // οӽǣָӽǣСĿӽǣvideos Ѱ cam_id 
+    std::vector<int> cam_ids;
+    for (const auto& video : videos) {
+        cam_ids.push_back(video.cam_id);
+    }
+    const std::size_t reference = choose_reference(cam_ids, decoded, options.reference_cam);
+    if (reference == videos.size()) {
+        std::cerr << "ûпͬ" << std::endl;
+        return offsets;
+    }
+    if (options.reference_cam >= 0 && videos[reference].cam_id != options.reference_cam) {
+        std::cerr << "οӽ Cam" << options.reference_cam << " ã Cam"
+                  << videos[reference].cam_id << std::endl;
+    }
+
+    std::vector<CameraOffset> results(videos.size());
+    std::vector<char> estimated(videos.size(), 0);
+    const int max_lag = static_cast<int>(options.max_offset_seconds * options.sample_rate);
+    run_per_camera(videos.size(), [&](std::size_t i) {
+        if (!decoded[i] || i == reference) {
+            return;
+        }
+        double lag = 0.0;
+        double confidence = 0.0;
+        if (estimate_signal_lag(tracks[reference], tracks[i], max_lag, lag, confidence)) {
+            results[i].offset_ms = lag * 1000.0 / options.sample_rate;
+            results[i].confidence = confidence;
+            estimated[i] = 1;
+        }
+    });
+
+    offsets[videos[reference].cam_id] = CameraOffset{0.0, 1.0};
+    for (std::size_t i = 0; i < videos.size(); ++i) {
+        if (estimated[i]) {
+            offsets[videos[i].cam_id] = results[i];
+        }
+    }
+    return offsets;
+}
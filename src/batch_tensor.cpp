@@ -0,0 +1,102 @@
+#include "batch_tensor.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <opencv2/imgproc.hpp>
+
+#include "frame_format.hpp"
+
+namespace {
+// Ŀߴ磺ȹ̶߶ȰŲ뵽 size_multiple
+cv::Size target_size(cv::Size image, const TensorOptions& options) {
+    if (options.width <= 0) {
+        return image;
+    }
+    const int multiple = std::max(1, options.size_multiple);
+    int height = static_cast<int>(static_cast<double>(image.height) * options.width / image.width);
+    height = std::max(multiple, height / multiple * multiple);
+    return {options.width, height};
+}
+} // namespace
+
+std::shared_ptr<std::vector<float>> TensorBufferPool::acquire(std::size_t elements) {
+    std::unique_ptr<std::vector<float>> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            buffer = std::move(free_.back());
+            free_.pop_back();
+        }
+    }
+    if (!buffer) {
+        buffer = std::make_unique<std::vector<float>>();
+    }
+    buffer->resize(elements);
+
+    // ڻʱֱͷڴ
+    std::weak_ptr<TensorBufferPool> weak_pool = weak_from_this();
+    return std::shared_ptr<std::vector<float>>(buffer.release(), [weak_pool](std::vector<float>* ptr) {
+        if (auto pool = weak_pool.lock()) {
+            pool->recycle(ptr);
+        } else {
+            delete ptr;
+        }
+    });
+}
+
+std::size_t TensorBufferPool::cached() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+}
+
+void TensorBufferPool::recycle(std::vector<float>* buffer) {
+    std::unique_ptr<std::vector<float>> owned(buffer);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.size() < max_cached_) {
+        free_.push_back(std::move(owned));
+    }
+}
+
+BatchTensor make_batch_tensor(const FrameBatch& batch, const TensorOptions& options,
+                              TensorBufferPool* pool) {
+    BatchTensor tensor;
+    tensor.frame_index = batch.frame_index;
+    tensor.timestamp = batch.timestamp;
+    if (!batch.is_valid()) {
+        return tensor;
+    }
+
+    const cv::Mat& first = batch.frames.begin()->second;
+    if (first.empty()) {
+        return tensor;
+    }
+    const cv::Size size = target_size(frame_image_size(first, batch.pixel_format), options);
+    const std::size_t plane = static_cast<std::size_t>(size.area());
+    tensor.shape = {static_cast<std::int64_t>(batch.frames.size()), 3, size.height, size.width};
+    const std::size_t elements = batch.frames.size() * 3 * plane;
+    tensor.storage = pool != nullptr ? pool->acquire(elements)
+                                     : std::make_shared<std::vector<float>>(elements);
+
+    cv::Mat resized;
+    std::vector<cv::Mat> bgr;
+    std::size_t view = 0;
+    for (const auto& [cam_id, frame] : batch.frames) {
+        if (frame.empty() || frame.depth() != CV_8U) {
+            std::cerr << "Cam" << cam_id << " ֡ʽ֧תΪ" << std::endl;
+            return BatchTensor{};
+        }
+        // I420 ֡ YUV ƽСתɫ
+        convert_frame(frame, batch.pixel_format, resized, false, size);
+        cv::split(resized, bgr);
+
+        // ֱдڴ棺RGB ƽУͬʱ uint8->float һ
+        float* base = tensor.data() + view * 3 * plane;
+        for (int c = 0; c < 3; ++c) {
+            cv::Mat dst(size, CV_32FC1, base + c * plane);
+            bgr[2 - c].convertTo(dst, CV_32F, 1.0 / 255.0);
+        }
+        tensor.cam_ids.push_back(cam_id);
+        ++view;
+    }
+    return tensor;
+}
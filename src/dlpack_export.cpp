@@ -0,0 +1,35 @@
+#include "dlpack_export.hpp"
+
+#include <vector>
+
+namespace {
+// DLManagedTensor  manager_ctx״ѷʹڼЧ
+struct DLPackHolder {
+    BatchTensor tensor; // 
+    std::vector<std::int64_t> shape; // DLTensor::shape ָ
+    DLManagedTensor managed{};
+};
+
+void delete_holder(DLManagedTensor* managed) {
+    delete static_cast<DLPackHolder*>(managed->manager_ctx);
+}
+} // namespace
+
+DLManagedTensor* to_dlpack(const BatchTensor& tensor) {
+    if (!tensor.is_valid()) {
+        return nullptr;
+    }
+
+    auto* holder = new DLPackHolder{tensor, tensor.shape};
+    DLTensor& dl = holder->managed.dl_tensor;
+    dl.data = holder->tensor.data();
+    dl.device = {kDLCPU, 0};
+    dl.ndim = static_cast<std::int32_t>(holder->shape.size());
+    dl.dtype = {kDLFloat, 32, 1};
+    dl.shape = holder->shape.data();
+    dl.strides = nullptr; // 
+    dl.byte_offset = 0;
+    holder->managed.manager_ctx = holder;
+    holder->managed.deleter = delete_holder;
+    return &holder->managed;
+}
@@ -0,0 +1,112 @@
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "audio_sync.hpp"
+#include "flash_sync.hpp"
+#include "frame_extractor.hpp"
+#include "sync_offsets.hpp"
+
+namespace {
+// в
+struct SyncArgs {
+    std::filesystem::path input_dir = "saved_videos"; // ƵĿ¼cam_N/ Ŀ¼
+    std::filesystem::path output_path; // ƫļȱʡΪ input_dir/sync_offsets.csv
+    std::string mode = "audio"; // ͬݣaudio컥أ/ flash⣩
+    AudioSyncOptions audio; // Ƶز
+    FlashSyncOptions flash; // 
+};
+
+// ÷: estimate_sync_offsets [input_dir] [output_csv] [--mode audio|flash] [--reference CAM]
+//                             [--seconds S] [--max-offset S]
+//                             [--rate HZ]                                      (audio)
+//                             [--min-jump LUMA] [--backend opencv|libav]       (flash)
+bool parse_args(int argc, char** argv, SyncArgs& args) {
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--mode" && i + 1 < argc) {
+            args.mode = argv[++i];
+        } else if (arg == "--reference" && i + 1 < argc) {
+            args.audio.reference_cam = std::stoi(argv[++i]);
+            args.flash.reference_cam = args.audio.reference_cam;
+        } else if (arg == "--rate" && i + 1 < argc) {
+            args.audio.sample_rate = std::stoi(argv[++i]);
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            args.audio.analysis_seconds = std::stod(argv[++i]);
+            args.flash.analysis_seconds = args.audio.analysis_seconds;
+        } else if (arg == "--max-offset" && i + 1 < argc) {
+            args.audio.max_offset_seconds = std::stod(argv[++i]);
+            args.flash.max_offset_seconds = args.audio.max_offset_seconds;
+        } else if (arg == "--min-jump" && i + 1 < argc) {
+            args.flash.min_jump = std::stod(argv[++i]);
+        } else if (arg == "--backend" && i + 1 < argc) {
+            const std::string backend = argv[++i];
+            if (backend != "opencv" && backend != "libav") {
+                std::cerr << "ֵ֧Ľ: " << backend << std::endl;
+                return false;
+            }
+            args.flash.source.backend =
+                backend == "libav" ? VideoBackend::LibAV : VideoBackend::OpenCV;
+        } else if (arg.rfind("--", 0) != 0 && positional == 0) {
+            args.input_dir = arg;
+            ++positional;
+        } else if (arg.rfind("--", 0) != 0 && positional == 1) {
+            args.output_path = arg;
+            ++positional;
+        } else {
+            std::cerr << "δ֪: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (args.mode != "audio" && args.mode != "flash") {
+        std::cerr << "ֵ֧ͬʽ: " << args.mode << std::endl;
+        return false;
+    }
+    if (args.audio.sample_rate <= 0 || args.audio.analysis_seconds <= 0.0) {
+        std::cerr << "ʱΪ" << std::endl;
+        return false;
+    }
+    if (args.output_path.empty()) {
+        args.output_path = args.input_dir / "sync_offsets.csv";
+    }
+    return true;
+}
+} // namespace
+
+// ƸӽԲοӽǵʼƫƣд minimal_frame_extract --sync-offsets ʹõļ
+int main(int argc, char** argv) {
+    SyncArgs args;
+    if (!parse_args(argc, argv, args)) {
+        return 1;
+    }
+
+    const auto videos = find_camera_videos(args.input_dir);
+    if (videos.size() < 2) {
+        std::cerr << "Ҫ·Ƶܹͬƫ: " << args.input_dir << std::endl;
+        return 1;
+    }
+
+    const SyncOffsets offsets = args.mode == "flash" ? estimate_flash_offsets(videos, args.flash)
+                                                     : estimate_audio_offsets(videos, args.audio);
+    if (offsets.size() < 2) {
+        std::cerr << "õⲻ㣬޷ͬƫ" << std::endl;
+        return 1;
+    }
+    for (const auto& video : videos) {
+        const auto it = offsets.find(video.cam_id);
+        if (it == offsets.end()) {
+            std::cout << "Cam" << video.cam_id << ": δܹ" << std::endl;
+            continue;
+        }
+        std::cout << "Cam" << video.cam_id << ": ƫ " << std::fixed << std::setprecision(2)
+                  << it->second.offset_ms << " ms, Ŷ " << std::setprecision(3)
+                  << it->second.confidence << std::endl;
+    }
+    if (!save_sync_offsets(args.output_path, offsets)) {
+        return 1;
+    }
+    std::cout << "ͬƫд: " << args.output_path << std::endl;
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "file_access.hpp"
+
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// ԤĹʱŲ롢Ѷݻ۵һŶÿ֡ϵͳ
+constexpr std::uint64_t kDropStep = 8ull << 20; // ÿôѶݶһ
+constexpr std::uint64_t kKeepBehind = 4ull << 20; // ȡλ֮ݣض̾ seek
+} // namespace
+
+FileAccessHints::~FileAccessHints() {
+    close();
+}
+
+bool FileAccessHints::open(const std::filesystem::path& path, std::size_t readahead_bytes,
+                           bool drop_behind) {
+    close();
+#ifdef _WIN32
+    (void)path;
+    (void)readahead_bytes;
+    (void)drop_behind;
+    return false;
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        return false;
+    }
+    std::error_code error;
+    size_ = std::filesystem::file_size(path, error);
+    if (error) {
+        size_ = 0;
+    }
+    readahead_ = readahead_bytes;
+    drop_behind_ = drop_behind;
+    // ϵ˳ʾӴں˵Ԥڣ AVIO ȡʱЧ
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    reset(0);
+    return true;
+#endif
+}
+
+void FileAccessHints::close() {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+    fd_ = -1;
+    size_ = 0;
+    prefetched_ = 0;
+    dropped_ = 0;
+}
+
+void FileAccessHints::advance(std::uint64_t position) {
+#ifndef _WIN32
+    if (fd_ < 0) {
+        return;
+    }
+    if (readahead_ > 0 && position + readahead_ / 2 >= prefetched_ && prefetched_ < size_) {
+        const std::uint64_t begin = std::max(prefetched_, position);
+        const std::uint64_t end = std::min<std::uint64_t>(position + readahead_, size_);
+        if (end > begin) {
+            posix_fadvise(fd_, static_cast<off_t>(begin), static_cast<off_t>(end - begin),
+                          POSIX_FADV_WILLNEED);
+        }
+        prefetched_ = end;
+    }
+    if (drop_behind_ && position > dropped_ + kKeepBehind + kDropStep) {
+        const std::uint64_t end = position - kKeepBehind;
+        posix_fadvise(fd_, static_cast<off_t>(dropped_), static_cast<off_t>(end - dropped_),
+                      POSIX_FADV_DONTNEED);
+        dropped_ = end;
+    }
+#else
+    (void)position;
+#endif
+}
+
+void FileAccessHints::reset(std::uint64_t position) {
+    prefetched_ = position;
+    //  seek ¶ҳҪٴζ
+    dropped_ = std::min(dropped_, position);
+    advance(position);
+}
@@ -0,0 +1,150 @@
+#include "flash_sync.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "frame_format.hpp"
+
+namespace {
+// ƫ shift룩£signal  reference ƥʱ֮
+struct FlashMatch {
+    int matched = 0; // ƥϵ
+    double residual_sum = 0.0; // ƥ (signal - reference - shift) ֮ͣϸƫ
+};
+
+FlashMatch match_flashes(const std::vector<double>& reference, const std::vector<double>& signal,
+                         double shift, double tolerance) {
+    FlashMatch match;
+    std::size_t j = 0;
+    for (const double time : reference) {
+        const double expected = time + shift;
+        // жʱ˫ָǰ
+        while (j < signal.size() && signal[j] < expected - tolerance) {
+            ++j;
+        }
+        if (j < signal.size() && std::abs(signal[j] - expected) <= tolerance) {
+            ++match.matched;
+            match.residual_sum += signal[j] - expected;
+            ++j;
+        }
+    }
+    return match;
+}
+
+// ÿһԣο, ӽ⣩һѡƫƣȡƥһƥƽϸ
+bool solve_flash_offset(const std::vector<double>& reference, const std::vector<double>& signal,
+                        const FlashSyncOptions& options, CameraOffset& offset) {
+    const double tolerance = options.match_tolerance_ms / 1000.0;
+    double best_shift = 0.0;
+    FlashMatch best;
+    for (const double ref_time : reference) {
+        for (const double time : signal) {
+            const double shift = time - ref_time;
+            if (std::abs(shift) > options.max_offset_seconds) {
+                continue;
+            }
+            const FlashMatch match = match_flashes(reference, signal, shift, tolerance);
+            if (match.matched > best.matched) {
+                best = match;
+                best_shift = shift;
+            }
+        }
+    }
+    if (best.matched == 0) {
+        return false;
+    }
+    const double shift = best_shift + best.residual_sum / best.matched;
+    offset.offset_ms = shift * 1000.0;
+    offset.confidence = static_cast<double>(best.matched) /
+                        static_cast<double>(std::max(reference.size(), signal.size()));
+    return true;
+}
+} // namespace
+
+bool measure_luma_track(const std::filesystem::path& path, const FlashSyncOptions& options,
+                        LumaTrack& track) {
+    track = LumaTrack{};
+    VideoSourceOptions source_options = options.source;
+    source_options.output_width = options.thumbnail_width;
+    source_options.native_yuv = true; // ˲֧ʱ BGR
+    auto source = open_video_source(path, source_options);
+    if (!source) {
+        std::cerr << "޷Ƶ: " << path << std::endl;
+        return false;
+    }
+    track.fps = source->fps();
+    if (track.fps <= 0.0) {
+        std::cerr << "޷ȡ֡: " << path << std::endl;
+        return false;
+    }
+
+    const FramePixelFormat format =
+        source->outputs_yuv() ? FramePixelFormat::I420 : FramePixelFormat::BGR;
+    const std::size_t max_frames = static_cast<std::size_t>(options.analysis_seconds * track.fps);
+    cv::Mat frame;
+    cv::Mat buffer;
+    while (track.luma.size() < max_frames && source->read(frame)) {
+        track.luma.push_back(static_cast<float>(cv::mean(frame_luma(frame, format, buffer))[0]));
+    }
+    return !track.luma.empty();
+}
+
+std::vector<double> detect_flashes(const LumaTrack& track, double min_jump) {
+    std::vector<double> flashes;
+    const auto& luma = track.luma;
+    for (std::size_t k = 1; k < luma.size(); ++k) {
+        const double jump = luma[k] - luma[k - 1];
+        if (jump < min_jump) {
+            continue;
+        }
+        // Ծܷ kk+1 ֡ڵ k ֡عڼ俪ʼʱ֮֡ȸ֡ʱ
+        const double next =
+            k + 1 < luma.size() ? std::max(0.0, static_cast<double>(luma[k + 1] - luma[k])) : 0.0;
+        const double fraction = next / (jump + next);
+        flashes.push_back((static_cast<double>(k) + fraction) / track.fps);
+        // ʣ
+        while (k + 1 < luma.size() && luma[k + 1] - luma[k] >= min_jump) {
+            ++k;
+        }
+    }
+    return flashes;
+}
+
+SyncOffsets estimate_flash_offsets(const std::vector<CameraVideo>& videos,
+                                   const FlashSyncOptions& options) {
+    SyncOffsets offsets;
+    std::vector<std::vector<double>> flashes(videos.size());
+    std::vector<char> usable(videos.size(), 0);
+    run_per_camera(videos.size(), [&](std::size_t i) {
+        LumaTrack track;
+        if (measure_luma_track(videos[i].path, options, track)) {
+            flashes[i] = detect_flashes(track, options.min_jump);
+            usable[i] = flashes[i].empty() ? 0 : 1;
+        }
+    });
+    std::vector<int> cam_ids;
+    for (const auto& video : videos) {
+        cam_ids.push_back(video.cam_id);
+    }
+
+    const std::size_t reference = choose_reference(cam_ids, usable, options.reference_cam);
+    if (reference == videos.size()) {
+        std::cerr << "ûм⵽ͬ" << std::endl;
+        return offsets;
+    }
+    if (options.reference_cam >= 0 && videos[reference].cam_id != options.reference_cam) {
+        std::cerr << "οӽ Cam" << options.reference_cam << " ã Cam"
+                  << videos[reference].cam_id << std::endl;
+    }
+
+    offsets[videos[reference].cam_id] = CameraOffset{0.0, 1.0};
+    for (std::size_t i = 0; i < videos.size(); ++i) {
+        CameraOffset offset;
+        if (usable[i] && i != reference &&
+            solve_flash_offset(flashes[reference], flashes[i], options, offset)) {
+            offsets[videos[i].cam_id] = offset;
+        }
+    }
+    return offsets;
+}
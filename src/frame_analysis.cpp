@@ -0,0 +1,43 @@
+#include "frame_analysis.hpp"
+
+#include <algorithm>
+#include <opencv2/imgproc.hpp>
+
+#include "frame_format.hpp"
+
+void make_analysis_thumbnail(const cv::Mat& frame, FramePixelFormat format, int width,
+                             cv::Mat& thumbnail) {
+    if (frame.empty()) {
+        thumbnail.release();
+        return;
+    }
+    // I420 ֻȡ Y ƽ棻BGR СתҶȣɫתֻͼϽ
+    cv::Mat buffer;
+    const cv::Mat image = format == FramePixelFormat::BGR ? frame : frame_luma(frame, format, buffer);
+    cv::Mat small;
+    if (width > 0 && width < image.cols) {
+        const int height =
+            std::max(1, static_cast<int>(static_cast<double>(image.rows) * width / image.cols));
+        cv::resize(image, small, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+    } else {
+        small = image;
+    }
+    if (small.channels() == 1) {
+        small.copyTo(thumbnail);
+    } else {
+        cv::cvtColor(small, thumbnail, cv::COLOR_BGR2GRAY);
+    }
+}
+
+double sharpness_score(const cv::Mat& thumbnail) {
+    if (thumbnail.empty()) {
+        return 0.0;
+    }
+    // 8 λ 16 λз 3x3 ˹Ӧȸ
+    cv::Mat laplacian;
+    cv::Laplacian(thumbnail, laplacian, CV_16S);
+    cv::Scalar mean;
+    cv::Scalar stddev;
+    cv::meanStdDev(laplacian, mean, stddev);
+    return stddev[0] * stddev[0];
+}
@@ -1,19 +1,53 @@
 #include "frame_extractor.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <map>
 #include <opencv2/opencv.hpp>
 #include <vector>
 
+#include "frame_format.hpp"
+#include "pipeline_metrics.hpp"
+#include "pipeline_trace.hpp"
+#include "progress_reporter.hpp"
+
 namespace {
     // Ƶṹ
 struct VideoStream {
     int cam_id = -1; // ͷID
     std::filesystem::path path; // Ƶ·
-    std::unique_ptr<cv::VideoCapture> cap; // Ƶ
+    std::unique_ptr<VideoSource> source; // ƵԴˣ
     double fps = 0.0; // ֡
+    int first_frame = 0; // ĵ 0 ֡ԴƵе֡
+    int next_frame = 0; // һνõԴ֡ţ 0 ƣ
+    int last_index = -1; // Դ֡ţزʱͬһԴ֡ɱʱ̸
+    cv::Mat last; // ֡
+    int previous_index = -1; // ǰһԴ֡ţϲֵҪ֡
+    cv::Mat previous; // ǰһ֡
+    bool ended = false; // ȡʧܺٲ
+    int seek_retries = 0; // Ĵ
+    int seek_from = -1; // תǰȡʧܵ֡ţתûгɹʱ >= 0
+    StageMetrics* decode_metrics = nullptr; // ʱͳƣδָʱΪ
+    StageMetrics* grab_metrics = nullptr; // ֻ֡벻ȡͼĺʱͳ
+    MetricCounter* dropped_metrics = nullptr; // ӽȱ֡ʱ
+    ProgressCounter* progress = nullptr; // ȣδýȻ㱨ʱΪ
+};
+
+//һ·Ƶȡһ֡Ľ
+enum class ReadStatus {
+    Ok, // ֡
+    Skipped, // ֡λڳ seek Խڣû
+    Failed, // ʧܣļ𻵣
+};
+
+//seek_past_error Ľ
+enum class SeekResult {
+    Seeked, // 
+    EndOfStream, // ʵļ
+    Failed, // ޷þĿ곬ļλʧܣ
 };
 // жǷƵļ
 bool is_video_file(const std::filesystem::path& path) {
@@ -43,84 +77,439 @@ int parse_cam_id(const std::filesystem::path& path, int fallback) {
 }
 //ռƵ
 //input_dir:ƵĿ¼·
-//ֵ:Ƶ
-std::vector<VideoStream> collect_streams(const std::filesystem::path& input_dir) {
+//ֵ:Ƶϣ cam_id 
+//source_options:˲
+std::vector<VideoStream> collect_streams(const std::filesystem::path& input_dir,
+                                         const VideoSourceOptions& source_options) {
     std::vector<VideoStream> streams;
+
+    for (const auto& video : find_camera_videos(input_dir)) {
+        auto source = open_video_source(video.path, source_options);
+        if (!source) {
+            std::cerr << "޷Ƶ: " << video.path << std::endl;
+            continue;
+        }
+        //ͷšƵ·ƵԴ֡ʷװVideoStreamṹ壬ӵstreams
+        VideoStream stream;
+        stream.cam_id = video.cam_id;
+        stream.path = video.path;
+        stream.fps = source->fps(); //ȡƵ֡
+        stream.source = std::move(source);
+        streams.push_back(std::move(stream));
+    }
+
+    return streams;
+}
+
+//ͬƫƶ·Ƶ㣺ƫСӽǴӵ 0 ֡ʼӽ grab ȵ֡
+bool align_streams(std::vector<VideoStream>& streams, const std::map<int, double>& offsets_ms) {
+    if (offsets_ms.empty()) {
+        return true;
+    }
+    auto offset_of = [&](int cam_id) {
+        const auto it = offsets_ms.find(cam_id);
+        return it != offsets_ms.end() ? it->second : 0.0;
+    };
+    double min_offset = offset_of(streams.front().cam_id);
+    for (const auto& stream : streams) {
+        min_offset = std::min(min_offset, offset_of(stream.cam_id));
+    }
+    for (auto& stream : streams) {
+        const double lead_ms = offset_of(stream.cam_id) - min_offset;
+        const int lead_frames = static_cast<int>(std::lround(lead_ms / 1000.0 * stream.fps));
+        for (int i = 0; i < lead_frames; ++i) {
+            if (!stream.source->grab()) {
+                std::cerr << "Cam" << stream.cam_id << " Ƶͬƫ " << lead_ms << " ms" << std::endl;
+                return false;
+            }
+        }
+        stream.first_frame = lead_frames;
+    }
+    return true;
+}
+
+//һ֡
+bool decode_frame(VideoStream& stream, const ExtractOptions& options, cv::Mat& frame) {
+    //СƵԴɣLibAV ɫתʱһţֻҶ
+    StageTimer timer(stream.decode_metrics);
+    TraceSpan span("decode", stream.cam_id, stream.first_frame + stream.next_frame);
+    if (!options.grayscale) {
+        if (!stream.source->read(frame)) {
+            return false;
+        }
+        const std::size_t bytes = frame.total() * frame.elemSize();
+        timer.set_bytes(bytes);
+        if (stream.progress) {
+            stream.progress->add_frames(1, bytes);
+        }
+        return true;
+    }
+    cv::Mat decoded;
+    if (!stream.source->read(decoded)) {
+        return false;
+    }
+    const std::size_t bytes = decoded.total() * decoded.elemSize();
+    timer.set_bytes(bytes);
+    if (stream.progress) {
+        stream.progress->add_frames(1, bytes);
+    }
+    //I420  Y ƽǻҶͼɣɫת
+    const FramePixelFormat format =
+        stream.source->outputs_yuv() ? FramePixelFormat::I420 : FramePixelFormat::BGR;
+    cv::Mat buffer;
+    frame_luma(decoded, format, buffer).copyTo(frame);
+    return true;
+}
+
+//תһγɹ룺ȷ϶ȡʧܲļʱűת
+void confirm_seek(VideoStream& stream) {
+    if (stream.seek_from < 0) {
+        return;
+    }
+    std::cerr << "Cam" << stream.cam_id << " ڵ " << stream.seek_from << " ֡ȡʧܣ "
+              << stream.next_frame << " ֡" << std::endl;
+    stream.seek_from = -1;
+}
+
+//Դ֡Ϊ index ֡index Сһζ֡
+//мֻ֡grab루֡ʡȥɫת뿽
+ReadStatus read_frame(VideoStream& stream, const ExtractOptions& options, int index,
+                      cv::Mat& frame) {
+    if (index == stream.last_index) {
+        frame = stream.last;
+        return ReadStatus::Ok;
+    }
+    if (index == stream.previous_index) {
+        frame = stream.previous;
+        return ReadStatus::Ok;
+    }
+    //λԽ֡ seek 
+    if (index < stream.next_frame) {
+        return ReadStatus::Skipped;
+    }
+    for (; stream.next_frame < index; ++stream.next_frame) {
+        StageTimer timer(stream.grab_metrics);
+        TraceSpan span("grab", stream.cam_id, stream.first_frame + stream.next_frame);
+        if (!stream.source->grab()) {
+            return ReadStatus::Failed;
+        }
+        confirm_seek(stream);
+        if (stream.progress) {
+            stream.progress->add_frames(1);
+        }
+    }
+    if (!decode_frame(stream, options, frame)) {
+        return ReadStatus::Failed;
+    }
+    confirm_seek(stream);
+    ++stream.next_frame;
+    stream.previous_index = stream.last_index;
+    stream.previous = std::move(stream.last);
+    stream.last_index = index;
+    stream.last = frame;
+    return ReadStatus::Ok;
+}
+
+//ʱ time룩Ӧ֡ȡӽԴ֡ģʽʱԻǰ֡
+ReadStatus resample_frame(VideoStream& stream, const ExtractOptions& options, double time,
+                          cv::Mat& frame) {
+    //Сݲ 2.9999 ĸ䵽ǰһ֡
+    const double position = time * stream.fps + 1e-6;
+    if (options.resample == FrameResample::Nearest) {
+        return read_frame(stream, options, static_cast<int>(std::floor(position + 0.5)), frame);
+    }
+    const int index = static_cast<int>(std::floor(position));
+    const double weight = position - index;
+    cv::Mat before;
+    const ReadStatus status = read_frame(stream, options, index, before);
+    if (status != ReadStatus::Ok || weight < 1e-3) {
+        frame = before;
+        return status;
+    }
+    cv::Mat after;
+    if (read_frame(stream, options, index + 1, after) != ReadStatus::Ok) {
+        //ĩβûкһ֡ʱֱʹǰһ֡
+        frame = before;
+        return ReadStatus::Ok;
+    }
+    cv::addWeighted(before, 1.0 - weight, after, weight, 0.0, frame);
+    return ReadStatus::Ok;
+}
+
+//Ԥ̵һ·Ϊ׼֡δ֪ʱ 0
+//target_fps Ϊ 0 ʾزÿ frame_step Դ֡һ
+std::int64_t expected_batches(const std::vector<VideoStream>& streams, double target_fps, int frame_step) {
+    double shortest = -1.0;
+    for (const auto& stream : streams) {
+        const std::int64_t frame_count = stream.source->frame_count();
+        if (frame_count <= 0 || (target_fps > 0.0 && stream.fps <= 0.0)) {
+            return 0;
+        }
+        const double remaining = static_cast<double>(frame_count - stream.first_frame);
+        const double length = target_fps > 0.0 ? remaining / stream.fps * target_fps : remaining / frame_step;
+        shortest = shortest < 0.0 ? length : std::min(shortest, length);
+    }
+    return shortest > 0.0 ? static_cast<std::int64_t>(std::ceil(shortest)) : 0;
+}
+
+//ӵǰλ seek_skip_seconds ¿ʼ
+SeekResult seek_past_error(VideoStream& stream, const ExtractOptions& options) {
+    const std::int64_t frame_count = stream.source->frame_count();
+    //֡δ֪ʱתһ֡û˵Ѿļĩβ
+    if (frame_count <= 0 && stream.seek_from >= 0) {
+        return SeekResult::EndOfStream;
+    }
+    if (stream.seek_retries >= options.max_seek_retries) {
+        return SeekResult::Failed;
+    }
+    const int skip =
+        std::max(1, static_cast<int>(std::lround(options.seek_skip_seconds * stream.fps)));
+    const int target = stream.next_frame + skip;
+    if (frame_count > 0 && stream.first_frame + target >= frame_count) {
+        return SeekResult::Failed;
+    }
+    ++stream.seek_retries;
+    //ʵƵԴ֡Ϊ׼λȷʱ֡Ȼȷ
+    const std::int64_t landed = stream.source->seek(stream.first_frame + target);
+    if (landed < 0) {
+        //֡δ֪ʱĿ֮ûпɽ֡ļ
+        return frame_count > 0 ? SeekResult::Failed : SeekResult::EndOfStream;
+    }
+    //ת־Ƴٵתһγɹ루confirm_seekļʱ
+    if (stream.seek_from < 0) {
+        stream.seek_from = stream.next_frame;
+    }
+    stream.next_frame = static_cast<int>(landed - stream.first_frame);
+    stream.last_index = -1;
+    stream.previous_index = -1;
+    stream.last.release();
+    stream.previous.release();
+    return SeekResult::Seeked;
+}
+
+//Դһ·ƵĶȡʧܣ false ʾ֡
+bool handle_stream_error(VideoStream& stream, const ExtractOptions& options) {
+    if (options.error_policy == StreamErrorPolicy::Stop) {
+        return false;
+    }
+    //Ѷļĩβ
+    const std::int64_t frame_count = stream.source->frame_count();
+    if (frame_count > 0 && stream.first_frame + stream.next_frame >= frame_count) {
+        stream.ended = true;
+        return true;
+    }
+    if (options.error_policy == StreamErrorPolicy::SeekPastError) {
+        const SeekResult result = seek_past_error(stream, options);
+        if (result != SeekResult::Failed) {
+            stream.ended = result == SeekResult::EndOfStream;
+            return true;
+        }
+    }
+    std::cerr << "Cam" << stream.cam_id << " ڵ " << stream.next_frame << " ֡ȡʧܣ"
+              << (options.error_policy == StreamErrorPolicy::DropCamera
+                      ? "βٰӽ"
+                      : "νӽǼΪȱʧ")
+              << std::endl;
+    stream.ended = true;
+    return true;
+}
+
+//֡ظʽ
+FramePixelFormat batch_pixel_format(const std::vector<VideoStream>& streams,
+                                    const ExtractOptions& options) {
+    if (options.grayscale) {
+        return FramePixelFormat::Gray;
+    }
+    return streams.front().source->outputs_yuv() ? FramePixelFormat::I420 : FramePixelFormat::BGR;
+}
+
+//ɳ֡õƵԴ
+VideoSourceOptions make_source_options(const ExtractOptions& options) {
+    VideoSourceOptions source_options = options.source;
+    if (options.decode_width > 0) {
+        source_options.output_width = options.decode_width;
+    }
+    return source_options;
+}
+
+} // namespace
+
+std::vector<CameraVideo> find_camera_videos(const std::filesystem::path& input_dir) {
+    std::vector<CameraVideo> videos;
     int next_cam_id = 0;
+    if (!std::filesystem::exists(input_dir)) {
+        return videos;
+    }
 
     for (const auto& entry : std::filesystem::recursive_directory_iterator(input_dir)) {
         if (!entry.is_regular_file() || !is_video_file(entry.path())) {
             continue;
         }
-        int cam_id = parse_cam_id(entry.path(), next_cam_id++);
-		//entyr.path()  L"saved_videos\\cam_0"	std::filesystem::path
-        auto capture = std::make_unique<cv::VideoCapture>(entry.path().string());
-        if (!capture->isOpened()) {
-            std::cerr << "޷Ƶ: " << entry.path() << std::endl;
-            continue;
-        }
-        //ȡƵ֡
-        const double fps = capture->get(cv::CAP_PROP_FPS);
-        //ͷšƵ·Ƶ֡ʷװVideoStreamṹ壬ӵstreams
-        streams.push_back({cam_id, entry.path(), std::move(capture), fps});
+        //entyr.path()  L"saved_videos\\cam_0"	std::filesystem::path
+        videos.push_back({parse_cam_id(entry.path(), next_cam_id++), entry.path()});
     }
 
     //sort:Ȱcam_id
-    std::sort(streams.begin(), streams.end(),
-              [](const VideoStream& lhs, const VideoStream& rhs) { return lhs.cam_id < rhs.cam_id; });
-    
-    return streams;
+    std::sort(videos.begin(), videos.end(),
+              [](const CameraVideo& lhs, const CameraVideo& rhs) { return lhs.cam_id < rhs.cam_id; });
+    return videos;
 }
 
-} // namespace
-
 // ̱߳Ŀ¼µƵ֡β͵С
-// ԶرնС
-void extract_frames_single(const std::filesystem::path& input_dir,
-                           BlockingQueue<FrameBatch>& output_queue) {
+// ԶرնУǰرնʱֹͣ벢ء
+bool extract_frames_single(const std::filesystem::path& input_dir,
+                           BlockingQueue<FrameBatch>& output_queue,
+                           const ExtractOptions& options) {
     if (!std::filesystem::exists(input_dir)) {
         std::cerr << "Ŀ¼: " << input_dir << std::endl;
         output_queue.close();
-        return;
+        return false;
     }
 
-    auto streams = collect_streams(input_dir);
+    auto streams = collect_streams(input_dir, make_source_options(options));
     if (streams.empty()) {
         std::cerr << "Ŀ¼δҵƵ: " << input_dir << std::endl;
         output_queue.close();
-        return;
+        return false;
     }
 
+    if (!align_streams(streams, options.camera_offsets_ms)) {
+        output_queue.close();
+        return false;
+    }
+
+    //Ŀ֡زҪÿһ·֡
+    const bool resample = options.target_fps > 0.0;
+    if (resample) {
+        for (const auto& stream : streams) {
+            if (stream.fps <= 0.0) {
+                std::cerr << "Cam" << stream.cam_id << " ޷ȡ֡ʣز" << std::endl;
+                output_queue.close();
+                return false;
+            }
+        }
+    }
+
+    pipeline_tracer().name_thread("extract");
+    //ָѭȡѭֻԭӼ
+    PipelineMetrics& metrics = pipeline_metrics();
+    for (auto& stream : streams) {
+        stream.decode_metrics = metrics.stage("decode", stream.cam_id);
+        stream.grab_metrics = metrics.stage("grab", stream.cam_id);
+        stream.dropped_metrics = metrics.counter("frames_dropped", stream.cam_id);
+    }
+    StageMetrics* const assemble_metrics = metrics.stage("assemble");
+    StageMetrics* const push_metrics = metrics.stage("queue_push");
+
+    const int frame_step = resample ? 1 : std::max(1, options.frame_step);
+    //ȣӽǰʣԴ֡尴Ԥʣʱ
+    ProgressReporter& reporter = progress_reporter();
+    for (auto& stream : streams) {
+        const std::int64_t frame_count = stream.source->frame_count();
+        stream.progress = reporter.add("decode cam " + std::to_string(stream.cam_id),
+                                       frame_count > 0 ? frame_count - stream.first_frame : 0);
+    }
+    ProgressCounter* const batch_progress =
+        reporter.add("extract", expected_batches(streams, resample ? options.target_fps : 0.0, frame_step));
+    const FramePixelFormat pixel_format = batch_pixel_format(streams, options);
+    //ȱʧӽǷ missing_cams
+    const bool mark_missing = options.error_policy == StreamErrorPolicy::PartialBatch ||
+                              options.error_policy == StreamErrorPolicy::SeekPastError;
     int frame_index = 0;
     bool stop = false;
 
     while (!stop) {
+        //װһεܺʱӽǵĽ
+        std::optional<StageTimer> assemble_timer;
+        std::optional<TraceSpan> assemble_span;
+        assemble_timer.emplace(assemble_metrics);
+        assemble_span.emplace("assemble", -1, frame_index);
         FrameBatch batch;
         batch.frame_index = frame_index;
-        if (!streams.empty()) {
+        batch.pixel_format = pixel_format;
+        if (resample) {
+            batch.timestamp = frame_index / options.target_fps;
+        } else {
             const double fps = streams.front().fps;
             batch.timestamp = fps > 0.0 ? frame_index / fps : 0.0;
         }
 
         for (auto& stream : streams) {
+            if (stream.ended) {
+                if (mark_missing) {
+                    batch.missing_cams.push_back(stream.cam_id);
+                }
+                continue;
+            }
             cv::Mat frame;
-            //streamsеÿһ·VideoStream󣬶ȡһ֡ͼ
-            //read:Ƶжȡһ֡ͼ
-            if (!stream.cap->read(frame)) {
+            //streamsеÿһ·VideoStream󣬶ȡʱ̵һ֡ͼ
+            //زʱӽǰԼ֡ʻԴ֡ţֱʹ frame_index
+            const ReadStatus status =
+                resample ? resample_frame(stream, options, batch.timestamp, frame)
+                         : read_frame(stream, options, frame_index, frame);
+            if (status == ReadStatus::Ok) {
+                batch.frames.emplace(stream.cam_id, std::move(frame));
+                continue;
+            }
+            if (status == ReadStatus::Failed && !handle_stream_error(stream, options)) {
                 stop = true;
                 break;
             }
-            batch.frames.emplace(stream.cam_id, std::move(frame));
+            if (mark_missing) {
+                batch.missing_cams.push_back(stream.cam_id);
+            }
         }
 
-        if (stop) {
+        const bool all_ended = std::all_of(streams.begin(), streams.end(),
+                                           [](const VideoStream& stream) { return stream.ended; });
+        if (stop || all_ended) {
             break;
         }
+        for (const auto& stream : streams) {
+            if (stream.dropped_metrics && batch.frames.count(stream.cam_id) == 0) {
+                stream.dropped_metrics->add();
+            }
+        }
+        //ӽǶʱûп֡
+        if (!batch.is_valid()) {
+            frame_index += frame_step;
+            continue;
+        }
+        assemble_timer.reset();
+        assemble_span.reset();
 
-        output_queue.push(std::move(batch));
-        //֡ţ1һ֡Ķȡ
-        ++frame_index;
+        if (options.memory_budget) {
+            std::size_t bytes = 0;
+            for (const auto& [cam_id, frame] : batch.frames) {
+                bytes += frame.total() * frame.elemSize();
+            }
+            //Ԥþʱѽһ֮ⲻټ
+            batch.reservation = reserve_memory(options.memory_budget, bytes);
+            if (!batch.reservation) {
+                break;
+            }
+        }
+        if (batch_progress) {
+            batch_progress->add_frames(1);
+        }
+        //б߹رʱټ룻ʱĵȴ queue_push
+        StageTimer push_timer(push_metrics);
+        TraceSpan push_span("queue_push", -1, frame_index);
+        if (!output_queue.push(std::move(batch))) {
+            break;
+        }
+        //֡ǰ frame_stepһ֡ĶȡزʱΪʱ̵ţ
+        frame_index += frame_step;
     }
 
+    for (auto& stream : streams) {
+        if (stream.progress) {
+            stream.progress->finish();
+        }
+    }
+    if (batch_progress) {
+        batch_progress->finish();
+    }
     output_queue.close();
+    return !stop;
 }
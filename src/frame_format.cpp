@@ -0,0 +1,118 @@
+#include "frame_format.hpp"
+
+#include <iterator>
+#include <opencv2/imgproc.hpp>
+
+namespace {
+int resize_interpolation(cv::Size from, cv::Size to) {
+    return to.width < from.width ? cv::INTER_AREA : cv::INTER_LINEAR;
+}
+
+// I420 ȷֱ YUV ƽ棬ٶС֡һɫת
+void convert_i420(const cv::Mat& frame, cv::Size target, int code, cv::Mat& out) {
+    const cv::Size image = frame_image_size(frame, FramePixelFormat::I420);
+    // ɫƽȵһ룬Ϊʱֻת
+    if (target == image || target.width % 2 != 0 || target.height % 2 != 0) {
+        cv::Mat converted;
+        cv::cvtColor(frame, target == image ? out : converted, code);
+        if (target != image) {
+            cv::resize(converted, out, target, 0, 0, resize_interpolation(image, target));
+        }
+        return;
+    }
+
+    const cv::Mat src = frame.isContinuous() ? frame : frame.clone();
+    cv::Mat yuv(target.height * 3 / 2, target.width, CV_8UC1);
+    const int interpolation = resize_interpolation(image, target);
+    const cv::Size chroma(image.width / 2, image.height / 2);
+    const cv::Size target_chroma(target.width / 2, target.height / 2);
+
+    cv::Mat y_dst = yuv.rowRange(0, target.height);
+    cv::resize(src.rowRange(0, image.height), y_dst, target, 0, 0, interpolation);
+    unsigned char* src_chroma = const_cast<unsigned char*>(src.ptr(image.height));
+    unsigned char* dst_chroma = yuv.ptr(target.height);
+    for (int plane = 0; plane < 2; ++plane) {
+        cv::Mat plane_src(chroma, CV_8UC1, src_chroma + plane * chroma.area());
+        cv::Mat plane_dst(target_chroma, CV_8UC1, dst_chroma + plane * target_chroma.area());
+        cv::resize(plane_src, plane_dst, target_chroma, 0, 0, interpolation);
+    }
+    cv::cvtColor(yuv, out, code);
+}
+} // namespace
+
+cv::Size frame_image_size(const cv::Mat& frame, FramePixelFormat format) {
+    if (format == FramePixelFormat::I420) {
+        return {frame.cols, frame.rows * 2 / 3};
+    }
+    return frame.size();
+}
+
+cv::Mat frame_luma(const cv::Mat& frame, FramePixelFormat format, cv::Mat& buffer) {
+    switch (format) {
+    case FramePixelFormat::I420:
+        return frame.rowRange(0, frame_image_size(frame, format).height);
+    case FramePixelFormat::Gray:
+        return frame;
+    case FramePixelFormat::BGR:
+        break;
+    }
+    cv::cvtColor(frame, buffer, cv::COLOR_BGR2GRAY);
+    return buffer;
+}
+
+void convert_frame(const cv::Mat& frame, FramePixelFormat format, cv::Mat& out, bool rgb,
+                   cv::Size size) {
+    if (frame.empty()) {
+        out.release();
+        return;
+    }
+    const cv::Size image = frame_image_size(frame, format);
+    const cv::Size target = size.empty() ? image : size;
+
+    switch (format) {
+    case FramePixelFormat::I420:
+        convert_i420(frame, target, rgb ? cv::COLOR_YUV2RGB_I420 : cv::COLOR_YUV2BGR_I420, out);
+        return;
+    case FramePixelFormat::Gray: {
+        // ŵͨͼٸΪͨ
+        cv::Mat resized = frame;
+        if (target != image) {
+            cv::resize(frame, resized, target, 0, 0, resize_interpolation(image, target));
+        }
+        cv::cvtColor(resized, out, rgb ? cv::COLOR_GRAY2RGB : cv::COLOR_GRAY2BGR);
+        return;
+    }
+    case FramePixelFormat::BGR:
+        break;
+    }
+
+    if (target != image) {
+        cv::resize(frame, out, target, 0, 0, resize_interpolation(image, target));
+        if (rgb) {
+            cv::cvtColor(out, out, cv::COLOR_BGR2RGB);
+        }
+    } else if (rgb) {
+        cv::cvtColor(frame, out, cv::COLOR_BGR2RGB);
+    } else {
+        out = frame;
+    }
+}
+
+const FrameBatch& to_bgr_batch(const FrameBatch& batch, FrameBatch& converted) {
+    if (batch.pixel_format != FramePixelFormat::I420) {
+        return batch;
+    }
+    converted.frame_index = batch.frame_index;
+    converted.timestamp = batch.timestamp;
+    converted.segment_id = batch.segment_id;
+    converted.pixel_format = FramePixelFormat::BGR;
+    converted.sharpness = batch.sharpness;
+    //  converted е Matߴ粻ʱڴ
+    for (auto it = converted.frames.begin(); it != converted.frames.end();) {
+        it = batch.frames.count(it->first) == 0 ? converted.frames.erase(it) : std::next(it);
+    }
+    for (const auto& [cam_id, frame] : batch.frames) {
+        convert_frame(frame, batch.pixel_format, converted.frames[cam_id]);
+    }
+    return converted;
+}
@@ -0,0 +1,104 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "synthetic_video.hpp"
+
+namespace {
+// в
+struct GenerateArgs {
+    std::filesystem::path output_dir = "video_test"; // Ŀ¼ cam_N/ Ŀ¼
+    SyntheticVideoOptions video; // Ƶ
+};
+
+//  "WxH"
+bool parse_size(const std::string& text, int& width, int& height) {
+    const auto x = text.find('x');
+    if (x == std::string::npos) {
+        return false;
+    }
+    width = std::stoi(text.substr(0, x));
+    height = std::stoi(text.substr(x + 1));
+    return width > 0 && height > 0;
+}
+
+// ÷: generate_test_videos [output_dir] [--cams N] [--size WxH] [--fps F] [--duration S]
+//                            [--codec FOURCC] [--ext .avi|.mp4|...] [--gop N]
+//                            [--offset CAM:MS]... [--flash S]
+//                            [--short CAM]... [--short-fraction F] [--corrupt CAM]... [--seed N]
+bool parse_args(int argc, char** argv, GenerateArgs& args) {
+    SyntheticVideoOptions& video = args.video;
+    bool positional = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--cams" && i + 1 < argc) {
+            video.cameras = std::stoi(argv[++i]);
+        } else if (arg == "--size" && i + 1 < argc) {
+            if (!parse_size(argv[++i], video.width, video.height)) {
+                std::cerr << "ֱʸʽӦΪ WxH: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--fps" && i + 1 < argc) {
+            video.fps = std::stod(argv[++i]);
+        } else if (arg == "--duration" && i + 1 < argc) {
+            video.duration_seconds = std::stod(argv[++i]);
+        } else if (arg == "--codec" && i + 1 < argc) {
+            video.fourcc = argv[++i];
+            if (video.fourcc.size() != 4) {
+                std::cerr << "Ϊ 4 ַ FourCC: " << video.fourcc << std::endl;
+                return false;
+            }
+        } else if (arg == "--ext" && i + 1 < argc) {
+            video.extension = argv[++i];
+        } else if (arg == "--gop" && i + 1 < argc) {
+            video.gop = std::stoi(argv[++i]);
+        } else if (arg == "--offset" && i + 1 < argc) {
+            const std::string value = argv[++i];
+            const auto colon = value.find(':');
+            if (colon == std::string::npos) {
+                std::cerr << "ƫƸʽӦΪ CAM:MS: " << value << std::endl;
+                return false;
+            }
+            video.start_offsets_ms[std::stoi(value.substr(0, colon))] = std::stod(value.substr(colon + 1));
+        } else if (arg == "--flash" && i + 1 < argc) {
+            video.flash_at_seconds = std::stod(argv[++i]);
+        } else if (arg == "--short" && i + 1 < argc) {
+            video.short_cams.insert(std::stoi(argv[++i]));
+        } else if (arg == "--short-fraction" && i + 1 < argc) {
+            video.short_fraction = std::stod(argv[++i]);
+        } else if (arg == "--corrupt" && i + 1 < argc) {
+            video.corrupt_cams.insert(std::stoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            video.seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg.rfind("--", 0) != 0 && !positional) {
+            args.output_dir = arg;
+            positional = true;
+        } else {
+            std::cerr << "δ֪: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (video.cameras <= 0 || video.fps <= 0.0 || video.duration_seconds <= 0.0) {
+        std::cerr << "ӽ֡ʱΪ" << std::endl;
+        return false;
+    }
+    if (video.short_fraction <= 0.0 || video.short_fraction > 1.0) {
+        std::cerr << "--short-fraction Ӧ (0, 1] ֮" << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+// ɿɸֵĶλƵ minimal_video_read_testminimal_frame_extract ׼ʹ
+int main(int argc, char** argv) {
+    GenerateArgs args;
+    if (!parse_args(argc, argv, args)) {
+        return 1;
+    }
+    if (!generate_synthetic_videos(args.output_dir, args.video)) {
+        return 1;
+    }
+    std::cout << " " << args.video.cameras << " ·Ƶ: " << args.output_dir << std::endl;
+    return 0;
+}
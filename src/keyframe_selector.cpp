@@ -0,0 +1,59 @@
+#include "keyframe_selector.hpp"
+
+#include <iostream>
+#include <opencv2/core.hpp>
+
+#include "frame_analysis.hpp"
+
+bool KeyframeSelector::select(const FrameBatch& batch) {
+    ++total_;
+    if (!batch.is_valid()) {
+        return false;
+    }
+
+    // ³ֵӽǻߴ仯Ϊ仯
+    bool changed = reference_.size() != batch.frames.size();
+    double motion_sum = 0.0;
+    std::map<int, cv::Mat> thumbnails;
+    for (const auto& [cam_id, frame] : batch.frames) {
+        make_analysis_thumbnail(frame, batch.pixel_format, options_.thumbnail_width, thumbnail_);
+        const auto ref = reference_.find(cam_id);
+        if (ref == reference_.end() || ref->second.size() != thumbnail_.size()) {
+            changed = true;
+        } else {
+            // absdiff  mean  OpenCV  SIMD ں
+            cv::absdiff(thumbnail_, ref->second, diff_);
+            motion_sum += cv::mean(diff_)[0];
+        }
+        thumbnails.emplace(cam_id, thumbnail_.clone());
+    }
+    last_motion_ = motion_sum / static_cast<double>(batch.frames.size());
+
+    const bool gap_exceeded = options_.max_gap > 0 && gap_ + 1 >= options_.max_gap;
+    if (!changed && last_motion_ < options_.motion_threshold && !gap_exceeded) {
+        ++gap_;
+        return false;
+    }
+
+    // һαȽϣƯҲۻֵ
+    reference_ = std::move(thumbnails);
+    gap_ = 0;
+    ++selected_;
+    return true;
+}
+
+void select_keyframes(BlockingQueue<FrameBatch>& input, BlockingQueue<FrameBatch>& output,
+                      const KeyframeOptions& options) {
+    KeyframeSelector selector(options);
+    while (auto batch = input.pop()) {
+        if (!selector.select(*batch)) {
+            continue;
+        }
+        if (!output.push(std::move(*batch))) {
+            input.close();
+            break;
+        }
+    }
+    std::cout << "ؼ֡ѡ: " << selector.selected() << "/" << selector.total() << " " << std::endl;
+    output.close();
+}
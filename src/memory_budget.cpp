@@ -0,0 +1,120 @@
+#include "memory_budget.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+// ͣʱи澯С
+constexpr std::chrono::seconds kOvercommitLogInterval(60);
+
+// ȡߺԤ㲻ʾñС
+std::size_t to_mb(std::size_t bytes) { return (bytes + 1024 * 1024 - 1) / (1024 * 1024); }
+} // namespace
+
+MemoryBudget::MemoryBudget(std::size_t limit_bytes, std::chrono::milliseconds stall_timeout)
+    : limit_(limit_bytes), stall_timeout_(stall_timeout) {}
+
+bool MemoryBudget::acquire(std::size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!min_checked_ && limit_ > 0 && min_batches_ > 0) {
+        min_checked_ = true;
+        const std::size_t required = min_batches_ * bytes;
+        if (limit_ < required) {
+            std::cerr << "ڴԤ " << to_mb(limit_) << " MB Сˮͬʱе " << min_batches_
+                      << " Σÿ " << bytes / 1024 << " KBߵ " << to_mb(required)
+                      << " MB" << std::endl;
+            limit_ = required;
+        }
+    }
+    // ԤֻҪԤȫ黹
+    auto fits = [this, bytes]() {
+        return closed_ || limit_ == 0 || used_ + bytes <= limit_ || used_ == 0;
+    };
+    if (!fits()) {
+        const auto start = std::chrono::steady_clock::now();
+        ++blocked_count_;
+        while (!fits()) {
+            const std::uint64_t releases = releases_;
+            if (!released_.wait_for(lock, stall_timeout_, fits) && releases_ == releases) {
+                // ȴڼûκι黹ڵȸ룬ȴֻһ
+                ++overcommits_;
+                const auto now = std::chrono::steady_clock::now();
+                if (overcommits_logged_ == 0 || now - overcommit_logged_at_ >= kOvercommitLogInterval) {
+                    std::cerr << "ڴԤС׶γеռԤ㣬УԤ "
+                              << to_mb(limit_) << " MBۼ " << overcommits_ << " Σϴθ澯 "
+                              << overcommits_ - overcommits_logged_ << " Σ" << std::endl;
+                    overcommits_logged_ = overcommits_;
+                    overcommit_logged_at_ = now;
+                }
+                break;
+            }
+        }
+        blocked_seconds_ +=
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (closed_) {
+        return false;
+    }
+    used_ += bytes;
+    peak_ = std::max(peak_, used_);
+    return true;
+}
+
+void MemoryBudget::release(std::size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        used_ -= std::min(bytes, used_);
+        ++releases_;
+    }
+    released_.notify_all();
+}
+
+void MemoryBudget::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    released_.notify_all();
+}
+
+void MemoryBudget::set_min_batches(std::size_t batches) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    min_batches_ = batches;
+}
+
+std::size_t MemoryBudget::limit() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limit_;
+}
+
+std::size_t MemoryBudget::used() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return used_;
+}
+
+std::size_t MemoryBudget::peak() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_;
+}
+
+std::uint64_t MemoryBudget::blocked_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocked_count_;
+}
+
+double MemoryBudget::blocked_seconds() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocked_seconds_;
+}
+
+std::uint64_t MemoryBudget::overcommits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return overcommits_;
+}
+
+std::shared_ptr<MemoryReservation> reserve_memory(MemoryBudget* budget, std::size_t bytes) {
+    if (budget == nullptr || !budget->acquire(bytes)) {
+        return nullptr;
+    }
+    return std::make_shared<MemoryReservation>(*budget, bytes);
+}
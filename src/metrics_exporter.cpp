@@ -0,0 +1,300 @@
+#include "metrics_exporter.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// ߳ HTTP 붨ʱдļ֮ѯ
+constexpr int kPollMilliseconds = 200;
+
+// ֱͼͰϽ磨룩Ǵӵζвʱ
+constexpr double kBucketBounds[] = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+                                    0.025,  0.05,    0.1,    0.25,  0.5,    1.0,   2.5, 10.0};
+
+// ǩstage  camӽʱʡ cam
+std::string labels(const std::string& stage, int cam_id, const std::string& extra = {}) {
+    std::ostringstream oss;
+    oss << "{stage=\"" << stage << '"';
+    if (cam_id >= 0) {
+        oss << ",cam=\"" << cam_id << '"';
+    }
+    if (!extra.empty()) {
+        oss << ',' << extra;
+    }
+    oss << '}';
+    return oss.str();
+}
+
+std::string cam_labels(int cam_id) {
+    return cam_id >= 0 ? "{cam=\"" + std::to_string(cam_id) + "\"}" : std::string();
+}
+
+// ̳פڴ棨ֽڣ޷ȡʱ 0
+std::uint64_t resident_bytes() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    std::uint64_t size = 0;
+    std::uint64_t resident = 0;
+    if (statm >> size >> resident) {
+        return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+#ifndef _WIN32
+// ͷ󷵻ָꣻ·֣κ GET  /metrics 
+void respond(int client, const std::string& body) {
+    char request[1024];
+    pollfd pfd{client, POLLIN, 0};
+    if (poll(&pfd, 1, kPollMilliseconds) > 0) {
+        [[maybe_unused]] const auto received = recv(client, request, sizeof(request), 0);
+    }
+    std::ostringstream response;
+    response << "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+             << body.size() << "\r\nConnection: close\r\n\r\n"
+             << body;
+    const std::string text = response.str();
+    std::size_t sent = 0;
+    while (sent < text.size()) {
+        const auto n = send(client, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            break;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+}
+#endif
+} // namespace
+
+std::string format_prometheus(const PipelineMetrics& metrics) {
+    std::ostringstream out;
+    out.precision(9);
+    const auto stages = metrics.stages();
+
+    out << "# HELP vggt_stage_duration_seconds Per-call latency of pipeline stages.\n"
+        << "# TYPE vggt_stage_duration_seconds histogram\n";
+    for (const StageMetrics* stage : stages) {
+        const LatencyHistogram& latency = stage->latency;
+        for (const double bound : kBucketBounds) {
+            std::ostringstream le;
+            le << "le=\"" << bound << '"';
+            out << "vggt_stage_duration_seconds_bucket" << labels(stage->stage, stage->cam_id, le.str())
+                << ' ' << latency.count_at_most(static_cast<std::uint64_t>(bound * 1e9)) << '\n';
+        }
+        out << "vggt_stage_duration_seconds_bucket" << labels(stage->stage, stage->cam_id, "le=\"+Inf\"")
+            << ' ' << latency.count() << '\n';
+        out << "vggt_stage_duration_seconds_sum" << labels(stage->stage, stage->cam_id) << ' '
+            << latency.total_ns() / 1e9 << '\n';
+        out << "vggt_stage_duration_seconds_count" << labels(stage->stage, stage->cam_id) << ' '
+            << latency.count() << '\n';
+    }
+
+    out << "# HELP vggt_stage_bytes_total Bytes processed by pipeline stages.\n"
+        << "# TYPE vggt_stage_bytes_total counter\n";
+    for (const StageMetrics* stage : stages) {
+        out << "vggt_stage_bytes_total" << labels(stage->stage, stage->cam_id) << ' '
+            << stage->bytes.load() << '\n';
+    }
+
+    // ֡ӽǻܣ decode ׶Σת encode  PNG  imencode
+    std::map<int, std::uint64_t> decoded;
+    std::map<int, std::uint64_t> encoded;
+    for (const StageMetrics* stage : stages) {
+        if (stage->stage == "decode") {
+            decoded[stage->cam_id] += stage->latency.count();
+        } else if (stage->stage == "encode" || stage->stage == "imencode") {
+            encoded[stage->cam_id] += stage->latency.count();
+        }
+    }
+    out << "# HELP vggt_frames_decoded_total Frames decoded.\n"
+        << "# TYPE vggt_frames_decoded_total counter\n";
+    for (const auto& [cam_id, count] : decoded) {
+        out << "vggt_frames_decoded_total" << cam_labels(cam_id) << ' ' << count << '\n';
+    }
+    out << "# HELP vggt_frames_encoded_total Frames encoded to video or image files.\n"
+        << "# TYPE vggt_frames_encoded_total counter\n";
+    for (const auto& [cam_id, count] : encoded) {
+        out << "vggt_frames_encoded_total" << cam_labels(cam_id) << ' ' << count << '\n';
+    }
+
+    // ¼frames_dropped ȣͬĸӽдͬһָ
+    std::string last_name;
+    for (const MetricCounter* counter : metrics.counters()) {
+        const std::string family = "vggt_" + counter->name + "_total";
+        if (counter->name != last_name) {
+            out << "# TYPE " << family << " counter\n";
+            last_name = counter->name;
+        }
+        out << family << cam_labels(counter->cam_id) << ' ' << counter->value.load() << '\n';
+    }
+
+    const auto queues = metrics.queues();
+    auto queue_gauge = [&](const char* name, const char* type, const char* help, auto value) {
+        out << "# HELP " << name << ' ' << help << '\n' << "# TYPE " << name << ' ' << type << '\n';
+        for (const auto& [queue, stats] : queues) {
+            out << name << "{queue=\"" << queue << "\"} " << value(stats) << '\n';
+        }
+    };
+    if (!queues.empty()) {
+        queue_gauge("vggt_queue_depth", "gauge", "Current queue depth.",
+                    [](const QueueStats& stats) { return stats.depth; });
+        queue_gauge("vggt_queue_high_water", "gauge", "Maximum queue depth.",
+                    [](const QueueStats& stats) { return stats.high_water; });
+        queue_gauge("vggt_queue_average_depth", "gauge", "Time-weighted average queue depth.",
+                    [](const QueueStats& stats) { return stats.average_depth; });
+        queue_gauge("vggt_queue_push_blocked_seconds_total", "counter",
+                    "Time producers spent blocked on a full queue.",
+                    [](const QueueStats& stats) { return stats.push_blocked_seconds; });
+        queue_gauge("vggt_queue_pop_blocked_seconds_total", "counter",
+                    "Time consumers spent blocked on an empty queue.",
+                    [](const QueueStats& stats) { return stats.pop_blocked_seconds; });
+    }
+
+    const std::uint64_t rss = resident_bytes();
+    if (rss != 0) {
+        out << "# HELP vggt_process_resident_memory_bytes Resident set size.\n"
+            << "# TYPE vggt_process_resident_memory_bytes gauge\n"
+            << "vggt_process_resident_memory_bytes " << rss << '\n';
+    }
+    return out.str();
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(const MetricsExportOptions& options) {
+    stop();
+    options_ = options;
+    if (options_.textfile.empty() && options_.http_port <= 0) {
+        return true;
+    }
+    if (options_.http_port > 0 && !open_listener()) {
+        return false;
+    }
+    stop_requested_ = false;
+    running_ = true;
+    thread_ = std::thread(&MetricsExporter::run, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!running_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+    }
+    stop_cv_.notify_all();
+    thread_.join();
+    running_ = false;
+#ifndef _WIN32
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+#endif
+    if (!options_.textfile.empty()) {
+        write_textfile();
+    }
+}
+
+void MetricsExporter::run() {
+    auto next_write = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_requested_) {
+        lock.unlock();
+        if (!options_.textfile.empty() && std::chrono::steady_clock::now() >= next_write) {
+            write_textfile();
+            next_write = std::chrono::steady_clock::now() + options_.interval;
+        }
+        // м׽ʱ poll еȴӣֻ˯
+        if (listen_fd_ >= 0) {
+            serve_pending();
+            lock.lock();
+        } else {
+            lock.lock();
+            stop_cv_.wait_for(lock, std::chrono::milliseconds(kPollMilliseconds),
+                              [this]() { return stop_requested_; });
+        }
+    }
+}
+
+bool MetricsExporter::open_listener() {
+#ifdef _WIN32
+    std::cerr << "ǰƽ̨֧ HTTP ָ˿ڣ textfile " << std::endl;
+    return false;
+#else
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "޷ָ׽" << std::endl;
+        return false;
+    }
+    const int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(options_.http_port));
+    if (inet_pton(AF_INET, options_.http_address.c_str(), &address.sin_addr) != 1 ||
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd_, 8) != 0) {
+        std::cerr << "޷ָ˿: " << options_.http_address << ':' << options_.http_port
+                  << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    return true;
+#endif
+}
+
+void MetricsExporter::serve_pending() {
+#ifndef _WIN32
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    if (poll(&pfd, 1, kPollMilliseconds) <= 0 || (pfd.revents & POLLIN) == 0) {
+        return;
+    }
+    const int client = accept(listen_fd_, nullptr, nullptr);
+    if (client < 0) {
+        return;
+    }
+    respond(client, format_prometheus(metrics_));
+    ::close(client);
+#endif
+}
+
+bool MetricsExporter::write_textfile() const {
+    // дʱļٸnode_exporter дһļ
+    auto temp = options_.textfile;
+    temp += ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "޷дָļ: " << temp << std::endl;
+            return false;
+        }
+        file << format_prometheus(metrics_);
+        if (!file) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, options_.textfile, error);
+    if (error) {
+        std::cerr << "޷滻ָļ: " << options_.textfile << std::endl;
+        return false;
+    }
+    return true;
+}
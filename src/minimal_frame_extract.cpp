@@ -1,25 +1,433 @@
+#include <chrono>
+#include <deque>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
+#include "async_file_writer.hpp"
 #include "frame_batch.hpp"
 #include "frame_extractor.hpp"
+#include "frame_format.hpp"
+#include "keyframe_selector.hpp"
+#include "metrics_exporter.hpp"
+#include "npy_writer.hpp"
+#include "pipeline_metrics.hpp"
+#include "pipeline_trace.hpp"
+#include "progress_reporter.hpp"
+#include "scene_cut.hpp"
+#include "sharpness_filter.hpp"
+#include "shm_frame_ring.hpp"
+#include "sync_offsets.hpp"
 #include <opencv2/imgcodecs.hpp>
 
+namespace {
+// в
+struct ExtractArgs {
+    std::filesystem::path input_dir = "saved_videos"; // ƵĿ¼
+    std::filesystem::path output_dir = "extracted_frames"; // Ŀ¼
+    std::string format = "png"; // ʽpng / npy / tensor / shm
+    int chunk = 1; // npy/tensor ģʽÿļ
+    std::string shm_name = "/vggt_frames"; // shm ģʽµĹڴ
+    int shm_slots = 8; // shm ģʽµĲλ
+    bool shm_drop_without_reader = false; // shm ģʽûʱΣǵȴ
+    double keyframe_threshold = 0.0; // ˶ؼֵ֡>0 ʱùؼ֡ѡ
+    int max_gap = 30; // ؼ֡ģʽ
+    int sharpest_window = 0; // >1 ʱÿ N ֻһ
+    double scene_cut_threshold = 0.0; // ͷлֵ>0 ʱƬηֱ
+    ExtractOptions extract; // Сߴ硢Ҷȡ֡
+    std::filesystem::path metrics_path; // ǿʱͳƸ׶κʱʱӡд JSON
+    std::filesystem::path trace_path; // ǿʱ¼̵߳ʱߣʱд Chrome trace JSON
+    double progress_seconds = 0.0; // >0 ʱÿôӡһνʣʱ
+    MetricsExportOptions prometheus; // Prometheus textfile / HTTP ˿ڣ
+    std::size_t memory_budget_mb = 0; // >0 ʱƶ׶γе֡MB
+    AsyncWriterOptions writer; // png ģʽ첽дļĺ߳
+};
+
+// Ƭͳƣд segments.csv Ƭηַ
+struct SegmentInfo {
+    int first_frame = -1; // Ƭεһ֡
+    int last_frame = -1; // Ƭһ֡
+    std::size_t batches = 0; // Ƭ
+};
+
+// ׶֮еƽߵ
+constexpr std::size_t kQueueCapacity = 16;
+
+// shm ģʽµȴӵͷŲλʱ䣻δʱһֱȴ
+constexpr auto kShmPublishTimeout = std::chrono::seconds(30);
+
+// ÷: minimal_frame_extract [input_dir] [output_dir] [--format png|npy|tensor|shm] [--chunk N]
+//                             [--shm-name NAME] [--shm-slots N] [--shm-drop-without-reader]
+//                             [--keyframes MOTION_THRESHOLD] [--max-gap N] [--sharpest N]
+//                             [--scene-cuts HIST_DISTANCE]
+//                             [--decode-width W] [--gray] [--frame-step N] [--target-fps F] [--blend]
+//                             [--backend opencv|libav] [--decoder-threads N] [--lowres N] [--fast-decode]
+//                             [--yuv] [--sync-offsets FILE] [--on-error stop|drop|partial|seek]
+//                             [--readahead MB] [--drop-behind] [--io-buffer KB]
+//                             [--metrics FILE] [--trace FILE] [--progress SECONDS]
+//                             [--prom-file FILE] [--prom-interval SECONDS] [--prom-port PORT]
+//                             [--prom-address ADDR] [--memory-budget MB]
+//                             [--writer auto|io_uring|threads] [--writer-threads N]
+// --writer io_uring ΪʵԺˣδʵ liburing ֤Ĭϣautoʹ̳߳
+//  MB ΪλĲޣ1TBƻֽڲ
+constexpr std::size_t kMaxSizeMb = std::size_t{1} << 20;
+
+// ֵֵַ [min, max] ڣӡ󲢷 false
+template <typename T>
+bool parse_number(const std::string& option, const std::string& text, T min, T max, T& value) {
+    bool ok = false;
+    try {
+        std::size_t used = 0;
+        if constexpr (std::is_floating_point_v<T>) {
+            const double parsed = std::stod(text, &used);
+            ok = used == text.size() && parsed >= min && parsed <= max;
+            if (ok) {
+                value = static_cast<T>(parsed);
+            }
+        } else {
+            const long long parsed = std::stoll(text, &used);
+            ok = used == text.size() && parsed >= static_cast<long long>(min) &&
+                 static_cast<unsigned long long>(parsed) <= static_cast<unsigned long long>(max);
+            if (ok) {
+                value = static_cast<T>(parsed);
+            }
+        }
+    } catch (const std::exception&) {
+        ok = false; // ֻ򳬳ͷΧ
+    }
+    if (!ok) {
+        std::cerr << " " << option << " ֵЧ: " << text;
+        if (max == std::numeric_limits<T>::max()) {
+            std::cerr << "ӦС " << min << "" << std::endl;
+        } else {
+            std::cerr << "Ӧ " << min << "  " << max << " ֮䣩" << std::endl;
+        }
+    }
+    return ok;
+}
+
+bool parse_args(int argc, char** argv, ExtractArgs& args) {
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            args.format = argv[++i];
+        } else if (arg == "--chunk" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 1, std::numeric_limits<int>::max(), args.chunk)) {
+                return false;
+            }
+        } else if (arg == "--shm-name" && i + 1 < argc) {
+            args.shm_name = argv[++i];
+        } else if (arg == "--shm-drop-without-reader") {
+            args.shm_drop_without_reader = true;
+        } else if (arg == "--shm-slots" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 1, std::numeric_limits<int>::max(), args.shm_slots)) {
+                return false;
+            }
+        } else if (arg == "--keyframes" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0.0, std::numeric_limits<double>::max(), args.keyframe_threshold)) {
+                return false;
+            }
+        } else if (arg == "--max-gap" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0, std::numeric_limits<int>::max(), args.max_gap)) {
+                return false;
+            }
+        } else if (arg == "--sharpest" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0, std::numeric_limits<int>::max(), args.sharpest_window)) {
+                return false;
+            }
+        } else if (arg == "--scene-cuts" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0.0, std::numeric_limits<double>::max(), args.scene_cut_threshold)) {
+                return false;
+            }
+        } else if (arg == "--decode-width" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0, std::numeric_limits<int>::max(), args.extract.decode_width)) {
+                return false;
+            }
+        } else if (arg == "--gray") {
+            args.extract.grayscale = true;
+        } else if (arg == "--frame-step" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 1, std::numeric_limits<int>::max(), args.extract.frame_step)) {
+                return false;
+            }
+        } else if (arg == "--target-fps" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0.0, std::numeric_limits<double>::max(), args.extract.target_fps)) {
+                return false;
+            }
+        } else if (arg == "--blend") {
+            args.extract.resample = FrameResample::Blend;
+        } else if (arg == "--backend" && i + 1 < argc) {
+            const std::string backend = argv[++i];
+            if (backend != "opencv" && backend != "libav") {
+                std::cerr << "ֵ֧Ľ: " << backend << std::endl;
+                return false;
+            }
+            args.extract.source.backend =
+                backend == "libav" ? VideoBackend::LibAV : VideoBackend::OpenCV;
+        } else if (arg == "--decoder-threads" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0, std::numeric_limits<int>::max(), args.extract.source.decoder_threads)) {
+                return false;
+            }
+        } else if (arg == "--lowres" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0, 3, args.extract.source.lowres)) {
+                return false;
+            }
+        } else if (arg == "--fast-decode") {
+            args.extract.source.skip_loop_filter = true;
+        } else if (arg == "--sync-offsets" && i + 1 < argc) {
+            // estimate_sync_offsets ɵƫļӽǰƫƶ
+            SyncOffsets offsets;
+            if (!load_sync_offsets(argv[++i], offsets)) {
+                return false;
+            }
+            args.extract.camera_offsets_ms = offsets_in_ms(offsets);
+        } else if (arg == "--on-error" && i + 1 < argc) {
+            const std::string policy = argv[++i];
+            if (policy == "stop") {
+                args.extract.error_policy = StreamErrorPolicy::Stop;
+            } else if (policy == "drop") {
+                args.extract.error_policy = StreamErrorPolicy::DropCamera;
+            } else if (policy == "partial") {
+                args.extract.error_policy = StreamErrorPolicy::PartialBatch;
+            } else if (policy == "seek") {
+                args.extract.error_policy = StreamErrorPolicy::SeekPastError;
+            } else {
+                std::cerr << "ֵ֧ĳʽ: " << policy << std::endl;
+                return false;
+            }
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            args.metrics_path = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            args.trace_path = argv[++i];
+        } else if (arg == "--progress" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0.0, std::numeric_limits<double>::max(), args.progress_seconds)) {
+                return false;
+            }
+        } else if (arg == "--prom-file" && i + 1 < argc) {
+            args.prometheus.textfile = argv[++i];
+        } else if (arg == "--prom-interval" && i + 1 < argc) {
+            double seconds = 0.0;
+            if (!parse_number(arg, argv[++i], 0.001, 86400.0, seconds)) {
+                return false;
+            }
+            args.prometheus.interval = std::chrono::milliseconds(static_cast<long long>(seconds * 1000));
+        } else if (arg == "--prom-port" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 0, 65535, args.prometheus.http_port)) {
+                return false;
+            }
+        } else if (arg == "--prom-address" && i + 1 < argc) {
+            args.prometheus.http_address = argv[++i];
+        } else if (arg == "--memory-budget" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], std::size_t{0}, kMaxSizeMb, args.memory_budget_mb)) {
+                return false;
+            }
+        } else if (arg == "--writer" && i + 1 < argc) {
+            const std::string backend = argv[++i];
+            if (backend == "auto") {
+                args.writer.backend = AsyncWriteBackend::Auto;
+            } else if (backend == "io_uring") {
+                args.writer.backend = AsyncWriteBackend::IoUring;
+                std::cerr << "io_uring дΪʵԹ" << std::endl;
+            } else if (backend == "threads") {
+                args.writer.backend = AsyncWriteBackend::ThreadPool;
+            } else {
+                std::cerr << "ֵ֧д: " << backend << std::endl;
+                return false;
+            }
+        } else if (arg == "--writer-threads" && i + 1 < argc) {
+            if (!parse_number(arg, argv[++i], 1, 256, args.writer.threads)) {
+                return false;
+            }
+        } else if (arg == "--readahead" && i + 1 < argc) {
+            std::size_t megabytes = 0;
+            if (!parse_number(arg, argv[++i], std::size_t{0}, kMaxSizeMb, megabytes)) {
+                return false;
+            }
+            args.extract.source.readahead_bytes = megabytes << 20;
+        } else if (arg == "--drop-behind") {
+            args.extract.source.drop_behind = true;
+        } else if (arg == "--io-buffer" && i + 1 < argc) {
+            //  libav ˣжȡļĻС
+            // AVIO С int 1GB
+            std::size_t kilobytes = 0;
+            if (!parse_number(arg, argv[++i], std::size_t{0}, std::size_t{1} << 20, kilobytes)) {
+                return false;
+            }
+            args.extract.source.io_buffer_bytes = kilobytes << 10;
+        } else if (arg == "--yuv") {
+            // ת I420 ֡ʱתҪ libav ˣ
+            args.extract.source.native_yuv = true;
+        } else if (arg.rfind("--", 0) != 0 && positional == 0) {
+            args.input_dir = arg;
+            ++positional;
+        } else if (arg.rfind("--", 0) != 0 && positional == 1) {
+            args.output_dir = arg;
+            ++positional;
+        } else {
+            std::cerr << "δ֪: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (args.format != "png" && args.format != "npy" && args.format != "tensor" &&
+        args.format != "shm") {
+        std::cerr << "ֵ֧ʽ: " << args.format << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// ƬĿ¼֡Ŀ¼ıŷʽһ
+std::string segment_dir_name(int segment_id) {
+    std::ostringstream oss;
+    oss << "segment_" << std::setw(3) << std::setfill('0') << segment_id;
+    return oss.str();
+}
+} // namespace
+
 int main(int argc, char** argv) {
-    const std::filesystem::path input_dir = "saved_videos";
-    const std::filesystem::path output_dir = "extracted_frames";
+    ExtractArgs args;
+    if (!parse_args(argc, argv, args)) {
+        return 1;
+    }
+    const std::filesystem::path& input_dir = args.input_dir;
+    const std::filesystem::path& output_dir = args.output_dir;
     std::filesystem::create_directories(output_dir);
-    BlockingQueue<FrameBatch> queue;
+    // ָڸ׶߳ǰ򿪣ʱȡԵͳ
+    PipelineMetrics& metrics = pipeline_metrics();
+    const bool export_prometheus = !args.prometheus.textfile.empty() || args.prometheus.http_port > 0;
+    metrics.set_enabled(!args.metrics_path.empty() || export_prometheus);
+    PipelineTracer& tracer = pipeline_tracer();
+    tracer.set_enabled(!args.trace_path.empty());
+    tracer.name_thread("writer");
+    ProgressReporter& reporter = progress_reporter();
+    if (args.progress_seconds > 0.0) {
+        reporter.start(std::chrono::milliseconds(static_cast<long long>(args.progress_seconds * 1000)),
+                       std::cout);
+    }
+    // ֡ݵڴԤ㣺ڽԤн׶ζͷź黹
+    std::unique_ptr<MemoryBudget> memory_budget;
+    if (args.memory_budget_mb > 0) {
+        memory_budget = std::make_unique<MemoryBudget>(args.memory_budget_mb * 1024 * 1024);
+        // ԤҪжװʱΡŴڵΣԼÿ׶ڴһ
+        // ׶ˮʱһ£ڽ߳ǰ
+        const std::size_t stage_count = 1 + (args.scene_cut_threshold > 0.0 ? 1 : 0) +
+                                        (args.sharpest_window > 1 ? 1 : 0) +
+                                        (args.keyframe_threshold > 0.0 ? 1 : 0);
+        const std::size_t window_batches =
+            args.sharpest_window > 1 ? static_cast<std::size_t>(args.sharpest_window) : 0;
+        memory_budget->set_min_batches(stage_count * (kQueueCapacity + 1) + window_batches);
+        args.extract.memory_budget = memory_budget.get();
+    }
+    // 롢ɸѡ׶дڸ߳ˮִУ׶֮нν
+    std::deque<BlockingQueue<FrameBatch>> queues;
+    std::vector<std::thread> stages;
+    // ½һУͳָʱ¼ȴʱ䣬дĽ׶
+    auto add_queue = [&](const char* producer) -> BlockingQueue<FrameBatch>& {
+        BlockingQueue<FrameBatch>& queue = queues.emplace_back(kQueueCapacity);
+        if (metrics.enabled()) {
+            queue.enable_stats();
+            metrics.add_queue(producer, [&queue]() { return queue.stats(); });
+        }
+        return queue;
+    };
+    BlockingQueue<FrameBatch>& extracted = add_queue("extract");
+    stages.emplace_back(extract_frames_single, input_dir, std::ref(extracted), args.extract);
 
-    extract_frames_single(input_dir, queue);
+    // ˮĩβ׷һ -> Ĵ׶
+    auto add_stage = [&](const char* name, auto stage, const auto& options) {
+        BlockingQueue<FrameBatch>& input = queues.back();
+        BlockingQueue<FrameBatch>& output = add_queue(name);
+        stages.emplace_back(stage, std::ref(input), std::ref(output), options);
+    };
+    // ͷлҪʱ̵֡ɸѡ׶֮ǰ
+    // Ȼʱ䴰ţٰ˶ɸѡؼ֡ȽϵĶ֡
+    const bool split_segments = args.scene_cut_threshold > 0.0;
+    if (split_segments) {
+        SceneCutOptions scene_cut_options;
+        scene_cut_options.threshold = args.scene_cut_threshold;
+        add_stage("scene_cut", tag_scene_cuts, scene_cut_options);
+    }
+    if (args.sharpest_window > 1) {
+        SharpnessOptions sharpness_options;
+        sharpness_options.window = args.sharpest_window;
+        add_stage("sharpest", select_sharpest, sharpness_options);
+    }
+    if (args.keyframe_threshold > 0.0) {
+        KeyframeOptions keyframe_options;
+        keyframe_options.motion_threshold = args.keyframe_threshold;
+        keyframe_options.max_gap = args.max_gap;
+        add_stage("keyframes", select_keyframes, keyframe_options);
+    }
+    BlockingQueue<FrameBatch>& source = queues.back();
+    // ̶߳ȡеͳƣڶ֮졢֮ǰ
+    MetricsExporter prometheus_exporter(metrics);
+    if (export_prometheus && !prometheus_exporter.start(args.prometheus)) {
+        for (auto& queue : queues) {
+            queue.close();
+        }
+        if (memory_budget) {
+            memory_budget->close();
+        }
+        for (auto& stage : stages) {
+            stage.join();
+        }
+        return 1;
+    }
+
+    int exit_code = 0;
     std::size_t batch_count = 0;
     std::size_t logged = 0;
     std::size_t saved_images = 0;
 
-    while (auto batch_opt = queue.pop()) {
+    // npy/tensor ģʽֱʽд .npyͼ룻ƬʱÿƬһ
+    const bool npy_format = args.format == "npy" || args.format == "tensor";
+    NpyExportOptions npy_options;
+    npy_options.content = args.format == "tensor" ? NpyContent::Tensor : NpyContent::Frames;
+    npy_options.batches_per_file = args.chunk;
+    std::unique_ptr<NpyBatchExporter> npy_exporter;
+    std::size_t npy_files = 0;
+    std::map<int, SegmentInfo> segments;
+    // shm ģʽηڴ滷λֱӳȡ
+    ShmFrameRingWriter shm_ring;
+    std::size_t shm_dropped = 0;
+
+    FrameBatch converted;
+    StageMetrics* const pop_metrics = metrics.stage("queue_pop");
+    // npy/tensor  shm μʱpng ӽǷֱʱ
+    StageMetrics* const write_metrics =
+        npy_format ? metrics.stage("npy_write")
+                   : args.format == "shm" ? metrics.stage("shm_publish") : nullptr;
+    std::map<int, StageMetrics*> encode_metrics;
+    // png ģʽֻ߳ڴ룬ļд뽻첽д
+    std::unique_ptr<AsyncFileWriter> png_writer;
+    if (args.format == "png") {
+        png_writer = std::make_unique<AsyncFileWriter>(args.writer);
+    }
+    ProgressCounter* const write_progress = reporter.add("write");
+    MetricCounter* const shm_dropped_metrics =
+        args.format == "shm" ? metrics.counter("batches_dropped") : nullptr;
+
+    while (true) {
+        std::optional<FrameBatch> batch_opt;
+        {
+            // ߵȴεʱ
+            StageTimer timer(pop_metrics);
+            TraceSpan span("queue_pop");
+            batch_opt = source.pop();
+        }
+        if (!batch_opt) {
+            break;
+        }
         const FrameBatch& batch = *batch_opt;
         ++batch_count;
 
@@ -29,28 +437,172 @@ int main(int argc, char** argv) {
             ++logged;
         }
 
-        for (const auto& [cam_id, frame] : batch.frames) {
+        const auto batch_output_dir =
+            split_segments ? output_dir / segment_dir_name(batch.segment_id) : output_dir;
+        SegmentInfo& segment = segments[batch.segment_id];
+        if (segment.first_frame < 0) {
+            segment.first_frame = batch.frame_index;
+        }
+        segment.last_frame = batch.frame_index;
+        ++segment.batches;
+
+        if (npy_format) {
+            // Ƭα仯ʱһƬεļ
+            if (!npy_exporter || segment.batches == 1) {
+                if (npy_exporter) {
+                    npy_exporter->close();
+                    npy_files += npy_exporter->files_written();
+                }
+                npy_exporter = std::make_unique<NpyBatchExporter>(batch_output_dir, npy_options);
+            }
+            StageTimer timer(write_metrics);
+            TraceSpan span("npy_write", -1, batch.frame_index);
+            if (npy_exporter->write(batch)) {
+                saved_images += batch.frames.size();
+                if (write_progress) {
+                    std::size_t bytes = 0;
+                    for (const auto& [cam_id, frame] : batch.frames) {
+                        bytes += frame.total() * frame.elemSize();
+                    }
+                    write_progress->add_frames(batch.frames.size(), 0, bytes);
+                }
+            }
+            continue;
+        }
+
+        // PNG 빲ڴ水 BGR/ҶI420 ɫת
+        const FrameBatch& packed = to_bgr_batch(batch, converted);
+
+        if (args.format == "shm") {
+            // һε֪ӽֱʣݴ˴ڴ
+            if (!shm_ring.is_open()) {
+                const cv::Mat& first = packed.frames.begin()->second;
+                ShmRingLayout layout;
+                layout.slot_count = static_cast<std::uint32_t>(args.shm_slots);
+                layout.max_cams = static_cast<std::uint32_t>(packed.frames.size());
+                layout.width = static_cast<std::uint32_t>(first.cols);
+                layout.height = static_cast<std::uint32_t>(first.rows);
+                layout.channels = static_cast<std::uint32_t>(first.channels());
+                if (!shm_ring.create(args.shm_name, layout)) {
+                    exit_code = 1;
+                    for (auto& queue : queues) {
+                        queue.close();
+                    }
+                    // ߳̿Ԥ
+                    if (memory_budget) {
+                        memory_budget->close();
+                    }
+                    break;
+                }
+            }
+            StageTimer timer(write_metrics);
+            TraceSpan span("shm_publish", -1, batch.frame_index);
+            if (shm_ring.publish(packed, kShmPublishTimeout, args.shm_drop_without_reader)) {
+                saved_images += batch.frames.size();
+                if (write_progress) {
+                    write_progress->add_frames(batch.frames.size());
+                }
+            } else {
+                ++shm_dropped;
+                if (shm_dropped_metrics) {
+                    shm_dropped_metrics->add();
+                }
+            }
+            continue;
+        }
+
+        // ÿֻһĿ¼ļд첽
+        std::ostringstream frame_dir_ss;
+        frame_dir_ss << "frame_" << std::setw(6) << std::setfill('0') << batch.frame_index;
+        const auto frame_dir = batch_output_dir / frame_dir_ss.str();
+        std::filesystem::create_directories(frame_dir);
+
+        for (const auto& [cam_id, frame] : packed.frames) {
             if (frame.empty()) {
                 continue;
             }
 
-            std::ostringstream frame_dir_ss;
-            frame_dir_ss << "frame_" << std::setw(6) << std::setfill('0') << batch.frame_index;
-            const auto frame_dir = output_dir / frame_dir_ss.str();
-            std::filesystem::create_directories(frame_dir);
-
             std::ostringstream oss;
             oss << "cam_" << cam_id << ".png";
-            const auto save_path = frame_dir / oss.str();
-            if (cv::imwrite(save_path.string(), frame)) {
-                ++saved_images;
+            auto metrics_it = encode_metrics.find(cam_id);
+            if (metrics_it == encode_metrics.end()) {
+                metrics_it = encode_metrics.emplace(cam_id, metrics.stage("imencode", cam_id)).first;
+            }
+            std::vector<unsigned char> encoded;
+            {
+                StageTimer timer(metrics_it->second);
+                TraceSpan span("imencode", cam_id, batch.frame_index);
+                timer.set_bytes(frame.total() * frame.elemSize());
+                if (!cv::imencode(".png", frame, encoded)) {
+                    std::cerr << "PNG ʧ: ֡ " << batch.frame_index << " ӽ " << cam_id
+                              << std::endl;
+                    continue;
+                }
+            }
+            const std::size_t bytes = encoded.size();
+            //  PNG Сԭʼ֡εԤԤεļȫдŹ黹
+            if (png_writer->write(frame_dir / oss.str(), std::move(encoded), batch.reservation) &&
+                write_progress) {
+                write_progress->add_frames(1, 0, bytes);
             }
         }
     }
+    // ȴŶӵļọ̈̄дɹĲż뱣
+    if (png_writer) {
+        png_writer->close();
+        saved_images += png_writer->files_written();
+    }
+
+    for (auto& stage : stages) {
+        stage.join();
+    }
+    if (write_progress) {
+        write_progress->finish();
+    }
+    reporter.stop();
+    prometheus_exporter.stop();
 
+    if (npy_exporter) {
+        npy_exporter->close();
+        npy_files += npy_exporter->files_written();
+        std::cout << "д npy ļ: " << npy_files << std::endl;
+    }
+    if (split_segments) {
+        std::ofstream segments_csv(output_dir / "segments.csv", std::ios::trunc);
+        segments_csv << "segment_id,dir,first_frame,last_frame,batches\n";
+        for (const auto& [segment_id, info] : segments) {
+            segments_csv << segment_id << ',' << segment_dir_name(segment_id) << ',' << info.first_frame
+                         << ',' << info.last_frame << ',' << info.batches << '\n';
+        }
+        std::cout << "Ƭ: " << segments.size() << std::endl;
+    }
+    if (shm_ring.is_open()) {
+        std::cout << "ڴ: " << shm_ring.published() << " Σ " << shm_dropped
+                  << " " << std::endl;
+        shm_ring.close();
+    }
     std::cout << "֡: " << batch_count << std::endl;
     std::cout << "ͼƬ: " << saved_images << std::endl;
-    return 0;
+    if (png_writer) {
+        std::cout << "д: " << png_writer->backend_name() << "д "
+                  << png_writer->bytes_written() / (1024 * 1024) << " MBʧ "
+                  << png_writer->failures() << " ļ" << std::endl;
+    }
+    if (memory_budget) {
+        std::cout << "ڴԤ: ֵ " << memory_budget->peak() / (1024 * 1024) << " / "
+                  << memory_budget->limit() / (1024 * 1024) << " MBȴ "
+                  << memory_budget->blocked_count() << " ι " << std::fixed << std::setprecision(2)
+                  << memory_budget->blocked_seconds() << " 룬 " << memory_budget->overcommits()
+                  << " " << std::defaultfloat << std::endl;
+    }
+    if (tracer.enabled() && !tracer.save(args.trace_path)) {
+        exit_code = 1;
+    }
+    if (metrics.enabled()) {
+        metrics.print(std::cout);
+        if (!metrics.save_json(args.metrics_path)) {
+            exit_code = 1;
+        }
+    }
+    return exit_code;
 }
-
-
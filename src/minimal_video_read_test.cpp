@@ -3,11 +3,14 @@
 #include <thread>
 #include <vector>
 
+#include "progress_reporter.hpp"
 #include "video_reader.hpp"
 
-int main() {
-    const std::filesystem::path input_dir = std::filesystem::path("D:/code/VGGTSyncMultiCam-Demo/video_test");
-    const std::filesystem::path output_dir = "saved_videos";
+// ÷: minimal_video_read_test [input_dir] [output_dir]
+// ûʵزʱ generate_test_videos video_test 
+int main(int argc, char** argv) {
+    const std::filesystem::path input_dir = argc > 1 ? argv[1] : "video_test";
+    const std::filesystem::path output_dir = argc > 2 ? argv[2] : "saved_videos";
     std::filesystem::create_directories(output_dir);
 
     if (!std::filesystem::exists(input_dir)) {
@@ -23,12 +26,14 @@ int main() {
     }
 
     VideoTaskManager task_manager(tasks);
+    // ʱתʱÿ 10 ӡһθ·
+    progress_reporter().start(std::chrono::seconds(10), std::cout);
 
     const size_t thread_count = 2;
     std::vector<std::thread> workers;
     workers.reserve(thread_count);
     for (size_t i = 0; i < thread_count; ++i) {
-        workers.emplace_back(video_read_thread, std::ref(task_manager));
+        workers.emplace_back(video_read_thread, std::ref(task_manager), VideoSourceOptions{});
     }
 
     while (!task_manager.all_tasks_completed()) {
@@ -41,6 +46,7 @@ int main() {
             worker.join();
         }
     }
+    progress_reporter().stop();
 
     auto completed = task_manager.get_completed_tasks();
     bool all_ok = true;
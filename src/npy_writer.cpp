@@ -0,0 +1,253 @@
+#include "npy_writer.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "frame_format.hpp"
+
+namespace {
+constexpr char kMagic[] = "\x93NUMPY";
+constexpr std::size_t kPreambleSize = 10; // ħ6ֽ + 汾2ֽ + ͷ2ֽ
+constexpr int kCountWidth = 20; // άԤַȣ int64
+
+std::size_t element_size(NpyWriter::DType dtype) {
+    return dtype == NpyWriter::DType::Float32 ? sizeof(float) : 1;
+}
+
+std::int64_t shape_elements(const std::vector<std::int64_t>& shape) {
+    std::int64_t total = 1;
+    for (const auto dim : shape) {
+        total *= dim;
+    }
+    return total;
+}
+
+std::vector<std::int64_t> frames_shape(const FrameBatch& batch) {
+    if (!batch.is_valid()) {
+        return {};
+    }
+    const cv::Mat& first = batch.frames.begin()->second;
+    return {static_cast<std::int64_t>(batch.frames.size()), first.rows, first.cols, first.channels()};
+}
+
+//  minimal_frame_extract Ŀ¼һµļ
+std::string numbered_name(const char* prefix, int index) {
+    std::ostringstream oss;
+    oss << prefix << std::setw(6) << std::setfill('0') << index << ".npy";
+    return oss.str();
+}
+} // namespace
+
+NpyWriter::~NpyWriter() {
+    close();
+}
+
+bool NpyWriter::open(const std::filesystem::path& path, DType dtype,
+                     const std::vector<std::int64_t>& item_shape, bool stacked) {
+    close();
+    path_ = path;
+    dtype_ = dtype;
+    item_shape_ = item_shape;
+    stacked_ = stacked;
+    count_ = 0;
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        std::cerr << "޷ļ: " << path << std::endl;
+        return false;
+    }
+
+    const std::string header = header_text();
+    header_size_ = kPreambleSize + header.size();
+    const auto header_len = static_cast<std::uint16_t>(header.size());
+    const char preamble[kPreambleSize] = {
+        kMagic[0], kMagic[1], kMagic[2], kMagic[3], kMagic[4], kMagic[5], 1, 0,
+        static_cast<char>(header_len & 0xFF), static_cast<char>(header_len >> 8)};
+    return write_bytes(preamble, kPreambleSize) && write_bytes(header.data(), header.size());
+}
+
+std::string NpyWriter::header_text() const {
+    std::ostringstream shape;
+    shape << "(";
+    if (stacked_) {
+        shape << std::left << std::setw(kCountWidth) << count_ << ", ";
+    }
+    for (std::size_t i = 0; i < item_shape_.size(); ++i) {
+        shape << item_shape_[i] << (i + 1 < item_shape_.size() || item_shape_.size() == 1 ? ", " : "");
+    }
+    shape << ")";
+
+    std::string header = "{'descr': '";
+    header += dtype_ == DType::Float32 ? "<f4" : "|u1";
+    header += "', 'fortran_order': False, 'shape': " + shape.str() + ", }";
+    // ͷǰ 10 ֽڣո뵽 64 ֽڣԻнβ
+    const std::size_t total = kPreambleSize + header.size() + 1;
+    header.append((64 - total % 64) % 64, ' ');
+    header.push_back('\n');
+    return header;
+}
+
+bool NpyWriter::write_bytes(const void* data, std::size_t bytes) {
+    file_.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    if (!file_) {
+        std::cerr << "дʧ: " << path_ << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool NpyWriter::write_frames(const FrameBatch& batch) {
+    if (!file_.is_open() || dtype_ != DType::UInt8 || (!stacked_ && count_ > 0)) {
+        return false;
+    }
+    const std::vector<std::int64_t> shape = frames_shape(batch);
+    if (shape != item_shape_) {
+        std::cerr << "֡ " << batch.frame_index << " ״ļһ: " << path_ << std::endl;
+        return false;
+    }
+    // ȼȫӽд룺дһʧܻøκȫλ
+    for (const auto& [cam_id, frame] : batch.frames) {
+        if (frame.depth() != CV_8U || frame.rows != item_shape_[1] || frame.cols != item_shape_[2] ||
+            frame.channels() != item_shape_[3]) {
+            std::cerr << "Cam" << cam_id << " ֡ߴͲһ" << std::endl;
+            return false;
+        }
+    }
+    for (const auto& [cam_id, frame] : batch.frames) {
+        // ڴһд룬ROI ȷ֡д
+        const std::size_t row_bytes = static_cast<std::size_t>(frame.cols) * frame.elemSize();
+        if (frame.isContinuous()) {
+            if (!write_bytes(frame.data, row_bytes * frame.rows)) {
+                return false;
+            }
+            continue;
+        }
+        for (int r = 0; r < frame.rows; ++r) {
+            if (!write_bytes(frame.ptr(r), row_bytes)) {
+                return false;
+            }
+        }
+    }
+    ++count_;
+    return true;
+}
+
+bool NpyWriter::write_tensor(const BatchTensor& tensor) {
+    if (!file_.is_open() || dtype_ != DType::Float32 || (!stacked_ && count_ > 0)) {
+        return false;
+    }
+    if (tensor.shape != item_shape_ ||
+        static_cast<std::int64_t>(tensor.size()) != shape_elements(item_shape_)) {
+        std::cerr << "֡ " << tensor.frame_index << " ״ļһ: " << path_ << std::endl;
+        return false;
+    }
+    if (!write_bytes(tensor.data(), tensor.size() * sizeof(float))) {
+        return false;
+    }
+    ++count_;
+    return true;
+}
+
+bool NpyWriter::close() {
+    if (!file_.is_open()) {
+        return true;
+    }
+    bool ok = true;
+    if (stacked_) {
+        // άȹ̶ͷȲ䣬ƶ
+        const std::string header = header_text();
+        file_.seekp(static_cast<std::streamoff>(kPreambleSize));
+        ok = write_bytes(header.data(), header.size());
+    }
+    file_.close();
+    const auto expected = header_size_ + static_cast<std::size_t>(count_ * shape_elements(item_shape_)) *
+                                             element_size(dtype_);
+    if (ok && std::filesystem::file_size(path_) != expected) {
+        std::cerr << "ļСͷһ: " << path_ << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+NpyBatchExporter::NpyBatchExporter(std::filesystem::path output_dir, NpyExportOptions options)
+    : output_dir_(std::move(output_dir)),
+      options_(options),
+      tensor_pool_(std::make_shared<TensorBufferPool>(1)) {
+    std::filesystem::create_directories(output_dir_);
+    index_.open(output_dir_ / "index.csv", std::ios::trunc);
+    index_ << std::fixed << std::setprecision(6);
+    index_ << "file,row,frame_index,timestamp,cam_ids\n";
+}
+
+NpyBatchExporter::~NpyBatchExporter() {
+    close();
+}
+
+bool NpyBatchExporter::start_file(const std::vector<std::int64_t>& item_shape) {
+    const bool stacked = options_.batches_per_file > 1;
+    const int file_index = static_cast<int>(files_written_);
+    current_name_ = numbered_name(stacked ? "chunk_" : "frame_", file_index);
+    item_shape_ = item_shape;
+    const auto dtype =
+        options_.content == NpyContent::Tensor ? NpyWriter::DType::Float32 : NpyWriter::DType::UInt8;
+    if (!writer_.open(output_dir_ / current_name_, dtype, item_shape, stacked)) {
+        return false;
+    }
+    ++files_written_;
+    return true;
+}
+
+bool NpyBatchExporter::write(const FrameBatch& input) {
+    if (!input.is_valid()) {
+        return false;
+    }
+    // ֡ݰ BGR/Ҷд make_batch_tensor ֱӴ I420 ת
+    const FrameBatch& batch =
+        options_.content == NpyContent::Frames ? to_bgr_batch(input, converted_) : input;
+
+    BatchTensor tensor;
+    std::vector<std::int64_t> item_shape;
+    if (options_.content == NpyContent::Tensor) {
+        tensor = make_batch_tensor(batch, options_.tensor, tensor_pool_.get());
+        if (!tensor.is_valid()) {
+            return false;
+        }
+        item_shape = tensor.shape;
+    } else {
+        item_shape = frames_shape(batch);
+    }
+
+    // д״仯ӽı䣩ʱļ
+    const bool full = writer_.count() >= std::max(1, options_.batches_per_file);
+    if (!writer_.is_open() || full || item_shape != item_shape_) {
+        if (!writer_.close() || !start_file(item_shape)) {
+            return false;
+        }
+    }
+
+    const std::int64_t row = writer_.count();
+    const bool ok = options_.content == NpyContent::Tensor ? writer_.write_tensor(tensor)
+                                                           : writer_.write_frames(batch);
+    if (!ok) {
+        return false;
+    }
+
+    index_ << current_name_ << ',' << row << ',' << batch.frame_index << ',' << batch.timestamp << ',';
+    bool first = true;
+    for (const auto& [cam_id, frame] : batch.frames) {
+        index_ << (first ? "" : ";") << cam_id;
+        first = false;
+    }
+    index_ << '\n';
+    return true;
+}
+
+bool NpyBatchExporter::close() {
+    const bool ok = writer_.close();
+    if (index_.is_open()) {
+        index_.close();
+    }
+    return ok;
+}
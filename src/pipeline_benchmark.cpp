@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "frame_batch.hpp"
+#include "frame_extractor.hpp"
+#include "npy_writer.hpp"
+#include "synthetic_video.hpp"
+#include "video_reader.hpp"
+
+// ˮ߻׼ԣС֡Ƶȡת桢ʽд JSON
+// ڰ汾֮ԱȡƵڹĿ¼ֳɣⲿزġ
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// в
+struct BenchmarkArgs {
+    std::filesystem::path output_path = "benchmark_results.json"; // JSON ļ
+    std::filesystem::path work_dir = "benchmark_work"; // ɲƵ뵼ļĿ¼
+    std::string filter; // ְֻӴ
+    int frames = 120; // ÿ·Ƶ֡
+    int repetitions = 3; // ÿظȡһ
+    bool keep = false; // Ŀ¼
+};
+
+// һĽ
+struct BenchmarkResult {
+    std::string name; //  extract/cams:4/res:1280x720
+    double seconds = 0.0; // һεĺʱ
+    double items = 0.0; // һδĿ֡ͼƬԪأ
+    double bytes = 0.0; // һδֽ0 ʾͳ
+};
+
+// һдĿֽ
+struct RunStats {
+    double items = 0.0;
+    double bytes = 0.0;
+};
+
+// õķֱ
+struct Resolution {
+    int width;
+    int height;
+};
+
+std::string resolution_name(const Resolution& res) {
+    return std::to_string(res.width) + "x" + std::to_string(res.height);
+}
+
+bool parse_args(int argc, char** argv, BenchmarkArgs& args) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            args.output_path = argv[++i];
+        } else if (arg == "--work-dir" && i + 1 < argc) {
+            args.work_dir = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            args.filter = argv[++i];
+        } else if (arg == "--frames" && i + 1 < argc) {
+            args.frames = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            args.repetitions = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--keep") {
+            args.keep = true;
+        } else {
+            std::cerr << "δ֪: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ŀ¼ļֽ
+double directory_bytes(const std::filesystem::path& dir) {
+    double total = 0.0;
+    if (!std::filesystem::exists(dir)) {
+        return total;
+    }
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        if (entry.is_regular_file()) {
+            total += static_cast<double>(entry.file_size());
+        }
+    }
+    return total;
+}
+
+// ƽѹʽӽʵĻ
+cv::Mat make_texture(const Resolution& res) {
+    const cv::Size size(res.width, res.height);
+    cv::Mat coarse(std::max(1, size.height / 16), std::max(1, size.width / 16), CV_8UC3);
+    cv::randu(coarse, cv::Scalar(0, 0, 0), cv::Scalar(255, 255, 255));
+    cv::Mat texture;
+    cv::resize(coarse, texture, size, 0, 0, cv::INTER_LINEAR);
+    return texture;
+}
+
+//  dir/cam_N/video.avi  cams · MJPG ƵѴʱֱӸ
+bool generate_videos(const std::filesystem::path& dir, int cams, const Resolution& res, int frames) {
+    if (std::filesystem::exists(dir / "ground_truth_offsets.csv")) {
+        return true;
+    }
+    SyntheticVideoOptions options;
+    options.cameras = cams;
+    options.width = res.width;
+    options.height = res.height;
+    options.duration_seconds = frames / options.fps;
+    return generate_synthetic_videos(dir, options);
+}
+
+// ÿ·ͬݵĲ
+FrameBatch make_batch(int cams, const Resolution& res) {
+    const cv::Mat texture = make_texture(res);
+    FrameBatch batch;
+    batch.frame_index = 0;
+    for (int cam = 0; cam < cams; ++cam) {
+        batch.frames.emplace(cam, texture.clone());
+    }
+    return batch;
+}
+
+// BlockingQueueproducers ߡconsumers ߹ items Ԫ
+RunStats run_queue(int producers, int consumers, std::size_t capacity, int items) {
+    BlockingQueue<int> queue(capacity);
+    std::atomic<int> popped{0};
+    std::vector<std::thread> threads;
+    const int per_producer = items / producers;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, per_producer]() {
+            for (int i = 0; i < per_producer; ++i) {
+                queue.push(i);
+            }
+        });
+    }
+    std::vector<std::thread> consumer_threads;
+    for (int c = 0; c < consumers; ++c) {
+        consumer_threads.emplace_back([&queue, &popped]() {
+            while (queue.pop()) {
+                popped.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    queue.close();
+    for (auto& thread : consumer_threads) {
+        thread.join();
+    }
+    return {static_cast<double>(popped.load()), 0.0};
+}
+
+// extract_frames_singleӽ뵽ȡε֡
+RunStats run_extract(const std::filesystem::path& input_dir) {
+    BlockingQueue<FrameBatch> queue(16);
+    std::thread extractor(extract_frames_single, input_dir, std::ref(queue), ExtractOptions{});
+    double frames = 0.0;
+    while (auto batch = queue.pop()) {
+        frames += static_cast<double>(batch->frames.size());
+    }
+    extractor.join();
+    return {frames, 0.0};
+}
+
+// video_read_threadworkers ߳ת input_dir µȫƵ
+RunStats run_ingest(const std::filesystem::path& input_dir, const std::filesystem::path& output_dir,
+                    int workers) {
+    std::filesystem::remove_all(output_dir);
+    const auto tasks = collect_video_tasks(input_dir, output_dir);
+    VideoTaskManager task_manager(tasks);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; ++i) {
+        threads.emplace_back(video_read_thread, std::ref(task_manager), VideoSourceOptions{});
+    }
+    while (!task_manager.all_tasks_completed()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    task_manager.trigger_exit();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // ĿΪƵҪֽ
+    return {static_cast<double>(tasks.size()), directory_bytes(input_dir)};
+}
+
+//  batches Σpng/jpg ֡дļnpy/tensor  NpyBatchExporter
+RunStats run_export(const std::string& format, const FrameBatch& batch, int batches,
+                    const std::filesystem::path& output_dir) {
+    std::filesystem::remove_all(output_dir);
+    std::filesystem::create_directories(output_dir);
+    if (format == "npy" || format == "tensor") {
+        NpyExportOptions options;
+        options.content = format == "tensor" ? NpyContent::Tensor : NpyContent::Frames;
+        options.batches_per_file = batches;
+        NpyBatchExporter exporter(output_dir, options);
+        FrameBatch current = batch;
+        for (int i = 0; i < batches; ++i) {
+            current.frame_index = i;
+            exporter.write(current);
+        }
+        exporter.close();
+    } else {
+        for (int i = 0; i < batches; ++i) {
+            for (const auto& [cam_id, frame] : batch.frames) {
+                std::ostringstream name;
+                name << i << '_' << cam_id << '.' << format;
+                cv::imwrite((output_dir / name.str()).string(), frame);
+            }
+        }
+    }
+    return {static_cast<double>(batches) * static_cast<double>(batch.frames.size()),
+            directory_bytes(output_dir)};
+}
+
+// иظȡһ
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(const BenchmarkArgs& args) : args_(args) {}
+
+    void run(const std::string& name, const std::function<RunStats()>& body) {
+        if (!args_.filter.empty() && name.find(args_.filter) == std::string::npos) {
+            return;
+        }
+        BenchmarkResult result;
+        result.name = name;
+        for (int i = 0; i < args_.repetitions; ++i) {
+            const auto start = Clock::now();
+            const RunStats stats = body();
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (i == 0 || seconds < result.seconds) {
+                result.seconds = seconds;
+                result.items = stats.items;
+                result.bytes = stats.bytes;
+            }
+        }
+        std::cout << std::left << std::setw(40) << name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(12) << result.seconds * 1000.0 << " ms"
+                  << std::setw(14) << items_per_second(result) << " items/s";
+        if (result.bytes > 0.0) {
+            std::cout << std::setw(10) << bytes_per_second(result) / (1024.0 * 1024.0) << " MB/s";
+        }
+        std::cout << std::endl;
+        results_.push_back(result);
+    }
+
+    // ṹ Google Benchmark  JSON ڸеĶԱȽű
+    bool write_json(const std::filesystem::path& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "޷ļ: " << path << std::endl;
+            return false;
+        }
+        const std::time_t now = std::time(nullptr);
+        char date[32] = {};
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        file << "{\n  \"context\": {\n"
+             << "    \"date\": \"" << date << "\",\n"
+             << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+             << "    \"opencv_version\": \"" << CV_VERSION << "\",\n"
+#ifdef NDEBUG
+             << "    \"library_build_type\": \"release\",\n"
+#else
+             << "    \"library_build_type\": \"debug\",\n"
+#endif
+             << "    \"frames_per_video\": " << args_.frames << ",\n"
+             << "    \"repetitions\": " << args_.repetitions << "\n  },\n"
+             << "  \"benchmarks\": [";
+        file << std::setprecision(6);
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const BenchmarkResult& result = results_[i];
+            file << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\", "
+                 << "\"real_time\": " << result.seconds * 1000.0 << ", \"time_unit\": \"ms\", "
+                 << "\"items_per_second\": " << items_per_second(result);
+            if (result.bytes > 0.0) {
+                file << ", \"bytes_per_second\": " << bytes_per_second(result);
+            }
+            file << "}";
+        }
+        file << "\n  ]\n}\n";
+        return static_cast<bool>(file);
+    }
+
+private:
+    static double items_per_second(const BenchmarkResult& result) {
+        return result.seconds > 0.0 ? result.items / result.seconds : 0.0;
+    }
+    static double bytes_per_second(const BenchmarkResult& result) {
+        return result.seconds > 0.0 ? result.bytes / result.seconds : 0.0;
+    }
+
+    const BenchmarkArgs& args_;
+    std::vector<BenchmarkResult> results_;
+};
+} // namespace
+
+// ÷: pipeline_benchmark [--out FILE] [--work-dir DIR] [--filter SUBSTR] [--frames N]
+//                          [--repetitions N] [--keep]
+int main(int argc, char** argv) {
+    BenchmarkArgs args;
+    if (!parse_args(argc, argv, args)) {
+        return 1;
+    }
+    std::filesystem::create_directories(args.work_dir);
+    BenchmarkRunner runner(args);
+
+    // У/
+    constexpr int kQueueItems = 1 << 20;
+    for (const int threads : {1, 2, 4}) {
+        for (const std::size_t capacity : {std::size_t{16}, std::size_t{0}}) {
+            std::ostringstream name;
+            name << "queue/producers:" << threads << "/consumers:" << threads
+                 << "/capacity:" << capacity;
+            runner.run(name.str(),
+                       [&]() { return run_queue(threads, threads, capacity, kQueueItems); });
+        }
+    }
+
+    // ֡ӽֱ
+    const std::vector<Resolution> resolutions = {{640, 360}, {1280, 720}, {1920, 1080}};
+    for (const auto& res : resolutions) {
+        for (const int cams : {1, 2, 4}) {
+            const std::string name =
+                "extract/cams:" + std::to_string(cams) + "/res:" + resolution_name(res);
+            if (!args.filter.empty() && name.find(args.filter) == std::string::npos) {
+                continue;
+            }
+            const auto dir =
+                args.work_dir / "videos" / resolution_name(res) / ("cams_" + std::to_string(cams));
+            if (!generate_videos(dir, cams, res, args.frames)) {
+                return 1;
+            }
+            runner.run(name, [&]() { return run_extract(dir); });
+        }
+    }
+
+    // Ƶȡת棺߳4 · 720p
+    const auto ingest_dir = args.work_dir / "videos" / "1280x720" / "cams_4";
+    const auto ingest_output = args.work_dir / "ingest_output";
+    for (const int workers : {1, 2, 4}) {
+        const std::string name = "ingest/workers:" + std::to_string(workers);
+        if (!args.filter.empty() && name.find(args.filter) == std::string::npos) {
+            continue;
+        }
+        if (!generate_videos(ingest_dir, 4, {1280, 720}, args.frames)) {
+            return 1;
+        }
+        runner.run(name, [&]() { return run_ingest(ingest_dir, ingest_output, workers); });
+    }
+
+    // 4 · 720p Σʽд 16 
+    const FrameBatch batch = make_batch(4, {1280, 720});
+    const auto export_dir = args.work_dir / "export_output";
+    for (const std::string format : {"png", "jpg", "npy", "tensor"}) {
+        runner.run("export/format:" + format,
+                   [&]() { return run_export(format, batch, 16, export_dir); });
+    }
+
+    const bool ok = runner.write_json(args.output_path);
+    if (ok) {
+        std::cout << "׼Խд: " << args.output_path << std::endl;
+    }
+    // ֻɾɵĿ¼work_dir ûеĿ¼
+    if (!args.keep) {
+        for (const char* generated : {"videos", "ingest_output", "export_output"}) {
+            std::filesystem::remove_all(args.work_dir / generated);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+#include "pipeline_metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+// λλãvalue > 0
+int highest_bit(std::uint64_t value) noexcept {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+double to_ms(std::uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1e6;
+}
+
+// ÿ봦ڵǽʱ
+double per_second(double amount, double elapsed_seconds) {
+    return elapsed_seconds > 0.0 ? amount / elapsed_seconds : 0.0;
+}
+} // namespace
+
+int LatencyHistogram::bucket_index(std::uint64_t value) noexcept {
+    if (value < static_cast<std::uint64_t>(kSubBuckets)) {
+        return static_cast<int>(value);
+    }
+    const int exponent = highest_bit(value);
+    const int sub = static_cast<int>(value >> (exponent - kSubBits)) - kSubBuckets;
+    return kSubBuckets + (exponent - kSubBits) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucket_upper(int index) noexcept {
+    if (index < kSubBuckets) {
+        return static_cast<std::uint64_t>(index);
+    }
+    const int shift = (index - kSubBuckets) / kSubBuckets;
+    const std::uint64_t sub = static_cast<std::uint64_t>((index - kSubBuckets) % kSubBuckets);
+    const std::uint64_t lower = (kSubBuckets + sub) << shift;
+    return lower + ((std::uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds) noexcept {
+    buckets_[bucket_index(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_ns_.fetch_add(nanoseconds, std::memory_order_relaxed);
+    std::uint64_t current = max_ns_.load(std::memory_order_relaxed);
+    while (nanoseconds > current &&
+           !max_ns_.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t LatencyHistogram::percentile_ns(double quantile) const noexcept {
+    const std::uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    const auto rank = static_cast<std::uint64_t>(
+        std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(total)));
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= std::max<std::uint64_t>(rank, 1)) {
+            return std::min(bucket_upper(i), max_ns());
+        }
+    }
+    return max_ns();
+}
+
+std::uint64_t LatencyHistogram::count_at_most(std::uint64_t bound_ns) const noexcept {
+    // ֻۼϽ粻 bound_ns Ͱ߽ڵͰ
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount && bucket_upper(i) <= bound_ns; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+    }
+    return seen;
+}
+
+StageMetrics* PipelineMetrics::stage(const std::string& name, int cam_id) {
+    if (!enabled()) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = stages_[{name, cam_id}];
+    if (!entry) {
+        entry = std::make_unique<StageMetrics>();
+        entry->stage = name;
+        entry->cam_id = cam_id;
+    }
+    return entry.get();
+}
+
+std::vector<const StageMetrics*> PipelineMetrics::stages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<const StageMetrics*> result;
+    result.reserve(stages_.size());
+    for (const auto& [key, metrics] : stages_) {
+        result.push_back(metrics.get());
+    }
+    return result;
+}
+
+MetricCounter* PipelineMetrics::counter(const std::string& name, int cam_id) {
+    if (!enabled()) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = counters_[{name, cam_id}];
+    if (!entry) {
+        entry = std::make_unique<MetricCounter>();
+        entry->name = name;
+        entry->cam_id = cam_id;
+    }
+    return entry.get();
+}
+
+std::vector<const MetricCounter*> PipelineMetrics::counters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<const MetricCounter*> result;
+    result.reserve(counters_.size());
+    for (const auto& [key, counter] : counters_) {
+        result.push_back(counter.get());
+    }
+    return result;
+}
+
+void PipelineMetrics::add_queue(const std::string& name, std::function<QueueStats()> stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_.emplace_back(name, std::move(stats));
+}
+
+std::vector<std::pair<std::string, QueueStats>> PipelineMetrics::queues() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<std::string, QueueStats>> result;
+    result.reserve(queues_.size());
+    for (const auto& [name, stats] : queues_) {
+        result.emplace_back(name, stats());
+    }
+    return result;
+}
+
+void PipelineMetrics::print(std::ostream& out) const {
+    const double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    out << "׶κʱͳƣ룩:" << std::endl;
+    out << std::left << std::setw(16) << "stage" << std::right << std::setw(6) << "cam"
+        << std::setw(10) << "count" << std::setw(10) << "p50" << std::setw(10) << "p99"
+        << std::setw(10) << "max" << std::setw(12) << "total" << std::setw(10) << "MB/s"
+        << std::endl;
+    out << std::fixed << std::setprecision(3);
+    for (const StageMetrics* metrics : stages()) {
+        const LatencyHistogram& latency = metrics->latency;
+        out << std::left << std::setw(16) << metrics->stage << std::right << std::setw(6);
+        if (metrics->cam_id >= 0) {
+            out << metrics->cam_id;
+        } else {
+            out << '-';
+        }
+        out << std::setw(10) << latency.count() << std::setw(10)
+            << to_ms(latency.percentile_ns(0.5)) << std::setw(10)
+            << to_ms(latency.percentile_ns(0.99)) << std::setw(10) << to_ms(latency.max_ns())
+            << std::setw(12) << to_ms(latency.total_ns()) << std::setw(10)
+            << per_second(static_cast<double>(metrics->bytes.load()) / 1e6, elapsed) << std::endl;
+    }
+    for (const MetricCounter* counter : counters()) {
+        out << counter->name;
+        if (counter->cam_id >= 0) {
+            out << " (cam " << counter->cam_id << ')';
+        }
+        out << ": " << counter->value.load() << std::endl;
+    }
+    const auto queue_stats = queues();
+    if (!queue_stats.empty()) {
+        out << "ͳƣȴʱ䵥λΪ룩:" << std::endl;
+        out << std::left << std::setw(16) << "queue" << std::right << std::setw(8) << "high"
+            << std::setw(8) << "avg" << std::setw(10) << "pushes" << std::setw(10) << "push_blk"
+            << std::setw(10) << "push_s" << std::setw(10) << "push_max" << std::setw(10)
+            << "pop_blk" << std::setw(10) << "pop_s" << std::setw(10) << "pop_max" << std::endl;
+        for (const auto& [name, stats] : queue_stats) {
+            out << std::left << std::setw(16) << name << std::right << std::setw(8)
+                << stats.high_water << std::setw(8) << std::setprecision(2) << stats.average_depth
+                << std::setw(10) << stats.pushes << std::setw(10) << stats.push_blocked
+                << std::setprecision(3) << std::setw(10) << stats.push_blocked_seconds
+                << std::setw(10) << stats.push_blocked_max_seconds << std::setw(10)
+                << stats.pop_blocked << std::setw(10) << stats.pop_blocked_seconds << std::setw(10)
+                << stats.pop_blocked_max_seconds << std::endl;
+        }
+    }
+    out << std::defaultfloat;
+}
+
+bool PipelineMetrics::save_json(const std::filesystem::path& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "޷дָļ: " << path << std::endl;
+        return false;
+    }
+    const double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    file << std::setprecision(9);
+    file << "{\n  \"elapsed_seconds\": " << elapsed << ",\n  \"stages\": [";
+    bool first = true;
+    for (const StageMetrics* metrics : stages()) {
+        const LatencyHistogram& latency = metrics->latency;
+        const double count = static_cast<double>(latency.count());
+        const double bytes = static_cast<double>(metrics->bytes.load());
+        file << (first ? "\n" : ",\n");
+        first = false;
+        file << "    {\"stage\": \"" << metrics->stage << "\", \"cam_id\": " << metrics->cam_id
+             << ", \"count\": " << latency.count() << ", \"bytes\": " << metrics->bytes.load()
+             << ", \"p50_ms\": " << to_ms(latency.percentile_ns(0.5))
+             << ", \"p90_ms\": " << to_ms(latency.percentile_ns(0.9))
+             << ", \"p99_ms\": " << to_ms(latency.percentile_ns(0.99))
+             << ", \"max_ms\": " << to_ms(latency.max_ns())
+             << ", \"total_ms\": " << to_ms(latency.total_ns())
+             << ", \"items_per_second\": " << per_second(count, elapsed)
+             << ", \"bytes_per_second\": " << per_second(bytes, elapsed) << "}";
+    }
+    file << "\n  ],\n  \"counters\": [";
+    first = true;
+    for (const MetricCounter* counter : counters()) {
+        file << (first ? "\n" : ",\n");
+        first = false;
+        file << "    {\"name\": \"" << counter->name << "\", \"cam_id\": " << counter->cam_id
+             << ", \"value\": " << counter->value.load() << "}";
+    }
+    file << "\n  ],\n  \"queues\": [";
+    first = true;
+    for (const auto& [name, stats] : queues()) {
+        file << (first ? "\n" : ",\n");
+        first = false;
+        file << "    {\"queue\": \"" << name << "\", \"depth\": " << stats.depth
+             << ", \"high_water\": " << stats.high_water
+             << ", \"average_depth\": " << stats.average_depth << ", \"pushes\": " << stats.pushes
+             << ", \"pops\": " << stats.pops << ", \"push_blocked\": " << stats.push_blocked
+             << ", \"push_blocked_seconds\": " << stats.push_blocked_seconds
+             << ", \"push_blocked_max_seconds\": " << stats.push_blocked_max_seconds
+             << ", \"pop_blocked\": " << stats.pop_blocked
+             << ", \"pop_blocked_seconds\": " << stats.pop_blocked_seconds
+             << ", \"pop_blocked_max_seconds\": " << stats.pop_blocked_max_seconds << "}";
+    }
+    file << "\n  ]\n}\n";
+    return static_cast<bool>(file);
+}
+
+PipelineMetrics& pipeline_metrics() {
+    static PipelineMetrics metrics;
+    return metrics;
+}
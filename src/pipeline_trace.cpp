@@ -0,0 +1,99 @@
+#include "pipeline_trace.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+ThreadTraceBuffer::ThreadTraceBuffer(int thread_id)
+    : head_(std::make_unique<Chunk>()), tail_(head_.get()), thread_id_(thread_id) {}
+
+ThreadTraceBuffer::~ThreadTraceBuffer() {
+    // head_ ֮Ŀ append зָ
+    Chunk* chunk = head_->next.load(std::memory_order_relaxed);
+    while (chunk != nullptr) {
+        Chunk* next = chunk->next.load(std::memory_order_relaxed);
+        delete chunk;
+        chunk = next;
+    }
+}
+
+void ThreadTraceBuffer::append(const TraceEvent& event) {
+    std::size_t size = tail_->size.load(std::memory_order_relaxed);
+    if (size == kChunkEvents) {
+        Chunk* chunk = new Chunk();
+        tail_->next.store(chunk, std::memory_order_release);
+        tail_ = chunk;
+        size = 0;
+    }
+    tail_->events[size] = event;
+    // д¼ٷȣȡ¼
+    tail_->size.store(size + 1, std::memory_order_release);
+}
+
+void PipelineTracer::record(const TraceEvent& event) {
+    thread_buffer().append(event);
+}
+
+ThreadTraceBuffer& PipelineTracer::thread_buffer() {
+    // ÿ̵߳һμ¼ʱǼԼĻ壻У߳˳Կɵ
+    thread_local ThreadTraceBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.push_back(std::make_unique<ThreadTraceBuffer>(static_cast<int>(buffers_.size()) + 1));
+        buffer = buffers_.back().get();
+    }
+    return *buffer;
+}
+
+void PipelineTracer::name_thread(const std::string& name) {
+    if (!enabled()) {
+        return;
+    }
+    const int thread_id = thread_buffer().thread_id();
+    std::lock_guard<std::mutex> lock(mutex_);
+    thread_names_.emplace_back(thread_id, name);
+}
+
+bool PipelineTracer::save(const std::filesystem::path& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "޷дʱļ: " << path << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Chrome trace ʱ䵥λ΢
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    auto separator = [&]() -> const char* {
+        const char* text = first ? "\n" : ",\n";
+        first = false;
+        return text;
+    };
+    for (const auto& [thread_id, name] : thread_names_) {
+        file << separator() << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+             << thread_id << ", \"args\": {\"name\": \"" << name << "\"}}";
+    }
+    for (const auto& buffer : buffers_) {
+        const int thread_id = buffer->thread_id();
+        buffer->for_each([&](const TraceEvent& event) {
+            file << separator() << "{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                 << thread_id << ", \"ts\": " << event.begin_ns / 1000.0
+                 << ", \"dur\": " << event.duration_ns / 1000.0 << ", \"args\": {";
+            if (event.cam_id >= 0) {
+                file << "\"cam\": " << event.cam_id;
+            }
+            if (event.frame_index >= 0) {
+                file << (event.cam_id >= 0 ? ", " : "") << "\"frame\": " << event.frame_index;
+            }
+            file << "}}";
+        });
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+PipelineTracer& pipeline_tracer() {
+    static PipelineTracer tracer;
+    return tracer;
+}
@@ -0,0 +1,122 @@
+#include "progress_reporter.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+// ʣʱʽΪ h:mm:ss
+std::string format_duration(double seconds) {
+    const auto total = static_cast<long long>(std::llround(seconds));
+    std::ostringstream oss;
+    oss << total / 3600 << ':' << std::setw(2) << std::setfill('0') << (total / 60) % 60 << ':'
+        << std::setw(2) << std::setfill('0') << total % 60;
+    return oss.str();
+}
+} // namespace
+
+ProgressReporter::~ProgressReporter() {
+    stop();
+}
+
+ProgressCounter* ProgressReporter::add(const std::string& name, std::int64_t total_frames) {
+    if (!running()) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.push_back(std::make_unique<ProgressCounter>());
+    ProgressCounter* counter = counters_.back().get();
+    counter->name = name;
+    counter->total_frames.store(total_frames, std::memory_order_relaxed);
+    last_frames_.push_back(0);
+    reported_finished_.push_back(0);
+    return counter;
+}
+
+void ProgressReporter::start(std::chrono::milliseconds interval, std::ostream& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running()) {
+        return;
+    }
+    stop_requested_ = false;
+    out_ = &out;
+    last_report_ = std::chrono::steady_clock::now();
+    running_.store(true, std::memory_order_relaxed);
+    thread_ = std::thread(&ProgressReporter::run, this, interval, std::ref(out));
+}
+
+void ProgressReporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running()) {
+            return;
+        }
+        stop_requested_ = true;
+    }
+    stop_cv_.notify_all();
+    thread_.join();
+    running_.store(false, std::memory_order_relaxed);
+    report(*out_);
+}
+
+void ProgressReporter::run(std::chrono::milliseconds interval, std::ostream& out) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_cv_.wait_for(lock, interval, [this]() { return stop_requested_; })) {
+        lock.unlock();
+        report(out, true);
+        lock.lock();
+    }
+}
+
+void ProgressReporter::report(std::ostream& out, bool skip_reported) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    const double interval = std::chrono::duration<double>(now - last_report_).count();
+    last_report_ = now;
+
+    std::ostringstream oss;
+    oss << std::fixed;
+    for (std::size_t i = 0; i < counters_.size(); ++i) {
+        const ProgressCounter& counter = *counters_[i];
+        const std::uint64_t frames = counter.frames.load(std::memory_order_relaxed);
+        const std::int64_t total = counter.total_frames.load(std::memory_order_relaxed);
+        const bool finished = counter.finished.load(std::memory_order_acquire);
+        if (skip_reported && reported_finished_[i]) {
+            continue;
+        }
+        reported_finished_[i] = finished;
+        const double elapsed = finished ? counter.seconds.load(std::memory_order_relaxed)
+                                        : std::chrono::duration<double>(now - counter.started).count();
+        const double average_fps = elapsed > 0.0 ? frames / elapsed : 0.0;
+        const double current_fps =
+            interval > 0.0 ? static_cast<double>(frames - last_frames_[i]) / interval : 0.0;
+        last_frames_[i] = frames;
+
+        oss << "[] " << counter.name << ": " << frames;
+        if (total > 0) {
+            oss << '/' << total << " (" << std::setprecision(1)
+                << 100.0 * static_cast<double>(frames) / static_cast<double>(total) << "%)";
+        }
+        oss << std::setprecision(1) << ", " << current_fps << " fps (ƽ " << average_fps << ")";
+        const std::uint64_t read = counter.bytes_read.load(std::memory_order_relaxed);
+        const std::uint64_t written = counter.bytes_written.load(std::memory_order_relaxed);
+        if (read != 0) {
+            oss << ",  " << read / 1e6 << " MB";
+        }
+        if (written != 0) {
+            oss << ", д " << written / 1e6 << " MB";
+        }
+        if (finished) {
+            oss << ", ";
+        } else if (total > 0 && average_fps > 0.0 && static_cast<std::int64_t>(frames) < total) {
+            oss << ", ʣ " << format_duration((total - static_cast<std::int64_t>(frames)) / average_fps);
+        }
+        oss << '\n';
+    }
+    out << oss.str() << std::flush;
+}
+
+ProgressReporter& progress_reporter() {
+    static ProgressReporter reporter;
+    return reporter;
+}
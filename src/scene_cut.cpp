@@ -0,0 +1,59 @@
+#include "scene_cut.hpp"
+
+#include <iostream>
+#include <opencv2/imgproc.hpp>
+
+#include "frame_analysis.hpp"
+
+bool SceneCutDetector::process(FrameBatch& batch) {
+    std::map<int, cv::Mat> histograms;
+    double distance_sum = 0.0;
+    int compared = 0;
+    const int channels[] = {0};
+    const int hist_size[] = {options_.bins};
+    const float range[] = {0.0f, 256.0f};
+    const float* ranges[] = {range};
+    for (const auto& [cam_id, frame] : batch.frames) {
+        make_analysis_thumbnail(frame, batch.pixel_format, options_.thumbnail_width, thumbnail_);
+        if (thumbnail_.empty()) {
+            continue;
+        }
+        cv::Mat hist;
+        cv::calcHist(&thumbnail_, 1, channels, cv::Mat(), hist, 1, hist_size, ranges);
+        hist /= static_cast<double>(thumbnail_.total());
+        const auto previous = previous_.find(cam_id);
+        if (previous != previous_.end()) {
+            distance_sum += cv::compareHist(hist, previous->second, cv::HISTCMP_BHATTACHARYYA);
+            ++compared;
+        }
+        histograms.emplace(cam_id, std::move(hist));
+    }
+    previous_ = std::move(histograms);
+    last_distance_ = compared > 0 ? distance_sum / compared : 0.0;
+
+    const bool cut = compared > 0 && last_distance_ > options_.threshold &&
+                     segment_length_ >= options_.min_segment_length;
+    if (cut) {
+        ++segment_id_;
+        segment_length_ = 0;
+    }
+    ++segment_length_;
+    batch.segment_id = segment_id_;
+    return cut;
+}
+
+void tag_scene_cuts(BlockingQueue<FrameBatch>& input, BlockingQueue<FrameBatch>& output,
+                    const SceneCutOptions& options) {
+    SceneCutDetector detector(options);
+    while (auto batch = input.pop()) {
+        if (detector.process(*batch)) {
+            std::cout << "֡ " << batch->frame_index << " ⵽ͷл "
+                      << detector.last_distance() << "ʼƬ " << detector.segment_id() << std::endl;
+        }
+        if (!output.push(std::move(*batch))) {
+            input.close();
+            return;
+        }
+    }
+    output.close();
+}
@@ -0,0 +1,66 @@
+#include "sharpness_filter.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "frame_analysis.hpp"
+
+void score_sharpness(FrameBatch& batch, int thumbnail_width) {
+    cv::Mat thumbnail;
+    for (const auto& [cam_id, frame] : batch.frames) {
+        make_analysis_thumbnail(frame, batch.pixel_format, thumbnail_width, thumbnail);
+        batch.sharpness[cam_id] = sharpness_score(thumbnail);
+    }
+}
+
+double batch_sharpness(const FrameBatch& batch) {
+    if (batch.sharpness.empty()) {
+        return 0.0;
+    }
+    double score = std::numeric_limits<double>::max();
+    for (const auto& [cam_id, value] : batch.sharpness) {
+        score = std::min(score, value);
+    }
+    return score;
+}
+
+std::optional<FrameBatch> SharpestSelector::push(FrameBatch batch) {
+    score_sharpness(batch, options_.thumbnail_width);
+    if (options_.window <= 1) {
+        return batch;
+    }
+
+    const double score = batch_sharpness(batch);
+    if (!best_ || score > best_score_) {
+        best_ = std::move(batch);
+        best_score_ = score;
+    }
+    if (++count_ < options_.window) {
+        return std::nullopt;
+    }
+    return flush();
+}
+
+std::optional<FrameBatch> SharpestSelector::flush() {
+    std::optional<FrameBatch> best = std::move(best_);
+    best_.reset();
+    best_score_ = 0.0;
+    count_ = 0;
+    return best;
+}
+
+void select_sharpest(BlockingQueue<FrameBatch>& input, BlockingQueue<FrameBatch>& output,
+                     const SharpnessOptions& options) {
+    SharpestSelector selector(options);
+    while (auto batch = input.pop()) {
+        auto selected = selector.push(std::move(*batch));
+        if (selected && !output.push(std::move(*selected))) {
+            input.close();
+            return;
+        }
+    }
+    if (auto tail = selector.flush()) {
+        output.push(std::move(*tail));
+    }
+    output.close();
+}
@@ -0,0 +1,366 @@
+#include "shm_frame_ring.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ̣ python/shm_frame_ring.pyԼЭ飬仯
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Ҫ 32 λԭ");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Ҫ 64 λԭ");
+static_assert(offsetof(ShmRingHeader, slot_stride) == 32, "ShmRingHeader ֱ仯");
+static_assert(offsetof(ShmRingHeader, closed) == 56, "ShmRingHeader ֱ仯");
+static_assert(offsetof(ShmRingHeader, write_seq) == 64, "ShmRingHeader ֱ仯");
+static_assert(offsetof(ShmRingHeader, read_seq) == 72, "ShmRingHeader ֱ仯");
+static_assert(offsetof(ShmRingHeader, reader_pid) == 80, "ShmRingHeader ֱ仯");
+static_assert(sizeof(ShmRingHeader) <= shm_ring::kHeaderBytes, "ShmRingHeader Ԥռ");
+static_assert(offsetof(ShmSlotHeader, frame_index) == 16, "ShmSlotHeader ֱ仯");
+static_assert(sizeof(ShmSlotHeader) == 32, "ShmSlotHeader ֱ仯");
+
+namespace {
+constexpr auto kPollInterval = std::chrono::microseconds(200);
+
+std::size_t align_up(std::size_t value) {
+    return (value + shm_ring::kAlignment - 1) / shm_ring::kAlignment * shm_ring::kAlignment;
+}
+
+unsigned char* slot_base(ShmRingHeader* header, std::uint64_t seq) {
+    auto* base = reinterpret_cast<unsigned char*>(header);
+    return base + shm_ring::kHeaderBytes + (seq % header->slot_count) * header->slot_stride;
+}
+
+std::int32_t* slot_cam_ids(unsigned char* slot) {
+    return reinterpret_cast<std::int32_t*>(slot + sizeof(ShmSlotHeader));
+}
+
+#ifndef _WIN32
+// ǷԴڣȨźҲ˵̴ڣ
+bool process_alive(std::uint32_t pid) {
+    return pid != 0 && (kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM);
+}
+
+// ͬڴѴʱдˣдԴ falseдѹرջ˳ true
+bool stale_segment(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return errno == ENOENT; // պñɾ
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < shm_ring::kHeaderBytes) {
+        ::close(fd);
+        std::cerr << "ͬڴ治֡λ: " << name << std::endl;
+        return false;
+    }
+    void* base = mmap(nullptr, shm_ring::kHeaderBytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "޷ӳ乲ڴ: " << name << std::endl;
+        return false;
+    }
+    const auto* header = static_cast<const ShmRingHeader*>(base);
+    bool stale = false;
+    if (std::memcmp(header->magic, shm_ring::kMagic, sizeof(header->magic)) != 0) {
+        std::cerr << "ͬڴ治֡λ: " << name << std::endl;
+    } else if (header->version == shm_ring::kVersion &&
+               header->closed.load(std::memory_order_acquire) == 0 &&
+               process_alive(header->writer_pid)) {
+        std::cerr << "ڴ " << name << " д˽ " << header->writer_pid << " ʹ"
+                  << std::endl;
+    } else {
+        stale = true; // ɰ汾Эûд˽̺ţ
+    }
+    munmap(base, shm_ring::kHeaderBytes);
+    return stale;
+}
+
+void unmap(void*& base, std::size_t& bytes) {
+    if (base != nullptr) {
+        munmap(base, bytes);
+    }
+    base = nullptr;
+    bytes = 0;
+}
+#endif
+} // namespace
+
+ShmFrameRingWriter::~ShmFrameRingWriter() {
+    close();
+}
+
+bool ShmFrameRingWriter::create(const std::string& name, const ShmRingLayout& layout) {
+    close();
+#ifdef _WIN32
+    std::cerr << "ǰƽ̨֧ POSIX ڴ: " << name << std::endl;
+    return false;
+#else
+    if (layout.slot_count == 0 || layout.max_cams == 0 || layout.width == 0 || layout.height == 0 ||
+        layout.channels == 0) {
+        std::cerr << "ڴ沼ֲЧ: " << name << std::endl;
+        return false;
+    }
+
+    const std::size_t frame_stride =
+        align_up(static_cast<std::size_t>(layout.width) * layout.height * layout.channels);
+    const std::size_t slot_header_bytes =
+        align_up(sizeof(ShmSlotHeader) + sizeof(std::int32_t) * layout.max_cams);
+    const std::size_t slot_stride = slot_header_bytes + frame_stride * layout.max_cams;
+    const std::size_t bytes = shm_ring::kHeaderBytes + slot_stride * layout.slot_count;
+
+    // ͬڴֻдѹرջ˳ϴ쳣˳ʱ滻
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        if (!stale_segment(name)) {
+            return false;
+        }
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd < 0) {
+        std::cerr << "޷ڴ: " << name << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        std::cerr << "޷ùڴС: " << name << std::endl;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "޷ӳ乲ڴ: " << name << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate ֤ڴΪ 0вλ state=EmptyΪ 0
+    name_ = name;
+    base_ = base;
+    bytes_ = bytes;
+    header_ = new (base) ShmRingHeader{};
+    std::memcpy(header_->magic, shm_ring::kMagic, sizeof(header_->magic));
+    header_->version = shm_ring::kVersion;
+    header_->slot_count = layout.slot_count;
+    header_->max_cams = layout.max_cams;
+    header_->height = layout.height;
+    header_->width = layout.width;
+    header_->channels = layout.channels;
+    header_->slot_stride = slot_stride;
+    header_->frame_stride = frame_stride;
+    header_->slot_header_bytes = slot_header_bytes;
+    header_->writer_pid = static_cast<std::uint32_t>(getpid());
+    header_->reader_pid.store(0, std::memory_order_relaxed);
+    header_->closed.store(0, std::memory_order_relaxed);
+    header_->write_seq.store(0, std::memory_order_relaxed);
+    header_->read_seq.store(0, std::memory_order_release);
+    next_seq_ = 0;
+    return true;
+#endif
+}
+
+bool ShmFrameRingWriter::publish(const FrameBatch& batch, std::chrono::milliseconds timeout,
+                                 bool drop_without_reader) {
+    if (header_ == nullptr || !batch.is_valid()) {
+        return false;
+    }
+    if (batch.frames.size() > header_->max_cams) {
+        std::cerr << "֡ " << batch.frame_index << " ӽڴλ" << std::endl;
+        return false;
+    }
+    for (const auto& [cam_id, frame] : batch.frames) {
+        if (frame.depth() != CV_8U || static_cast<std::uint32_t>(frame.cols) != header_->width ||
+            static_cast<std::uint32_t>(frame.rows) != header_->height ||
+            static_cast<std::uint32_t>(frame.channels()) != header_->channels) {
+            std::cerr << "Cam" << cam_id << " ֡ߴ빲ڴ沼ֲһ" << std::endl;
+            return false;
+        }
+    }
+
+    // ȴͷɵĲλʱֻӵٳٲͷŵĶˣ
+    // δʱȴӣӺ¼ʱǰα
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (next_seq_ - header_->read_seq.load(std::memory_order_acquire) >= header_->slot_count) {
+        if (!reader_attached()) {
+            if (drop_without_reader) {
+                return false;
+            }
+            if (!waiting_for_reader_) {
+                std::cerr << "ڴȴ: " << name_ << std::endl;
+                waiting_for_reader_ = true;
+            }
+            deadline = std::chrono::steady_clock::now() + timeout;
+        } else {
+            waiting_for_reader_ = false;
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+        }
+        std::this_thread::sleep_for(kPollInterval);
+    }
+
+    unsigned char* slot = slot_base(header_, next_seq_);
+    auto* slot_header = reinterpret_cast<ShmSlotHeader*>(slot);
+    slot_header->state.store(shm_ring::kSlotWriting, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::int32_t* cam_ids = slot_cam_ids(slot);
+    unsigned char* data = slot + header_->slot_header_bytes;
+    std::uint32_t view = 0;
+    for (const auto& [cam_id, frame] : batch.frames) {
+        // ڴаУ鿽ʱ鿽
+        cv::Mat dst(frame.rows, frame.cols, frame.type(), data + view * header_->frame_stride);
+        frame.copyTo(dst);
+        cam_ids[view] = cam_id;
+        ++view;
+    }
+    slot_header->cam_count = view;
+    slot_header->frame_index = batch.frame_index;
+    slot_header->timestamp = batch.timestamp;
+    slot_header->seq.store(next_seq_, std::memory_order_relaxed);
+    slot_header->state.store(shm_ring::kSlotReady, std::memory_order_release);
+    header_->write_seq.store(++next_seq_, std::memory_order_release);
+    return true;
+}
+
+bool ShmFrameRingWriter::reader_attached() const {
+#ifdef _WIN32
+    return false;
+#else
+    return header_ != nullptr && process_alive(header_->reader_pid.load(std::memory_order_acquire));
+#endif
+}
+
+void ShmFrameRingWriter::close() {
+#ifndef _WIN32
+    if (header_ != nullptr) {
+        header_->closed.store(1, std::memory_order_release);
+        header_ = nullptr;
+        unmap(base_, bytes_);
+        shm_unlink(name_.c_str());
+    }
+#endif
+}
+
+ShmFrameRingReader::~ShmFrameRingReader() {
+    close();
+}
+
+bool ShmFrameRingReader::open(const std::string& name) {
+    close();
+#ifdef _WIN32
+    std::cerr << "ǰƽ̨֧ POSIX ڴ: " << name << std::endl;
+    return false;
+#else
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        std::cerr << "޷򿪹ڴ: " << name << std::endl;
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < shm_ring::kHeaderBytes) {
+        std::cerr << "ڴСЧ: " << name << std::endl;
+        ::close(fd);
+        return false;
+    }
+    const auto bytes = static_cast<std::size_t>(st.st_size);
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "޷ӳ乲ڴ: " << name << std::endl;
+        return false;
+    }
+
+    auto* header = static_cast<ShmRingHeader*>(base);
+    if (std::memcmp(header->magic, shm_ring::kMagic, sizeof(header->magic)) != 0 ||
+        header->version != shm_ring::kVersion) {
+        std::cerr << "ڴЭ鲻ƥ: " << name << std::endl;
+        munmap(base, bytes);
+        return false;
+    }
+    // ǼΪˣһ˳ʱ
+    const auto pid = static_cast<std::uint32_t>(getpid());
+    std::uint32_t attached = header->reader_pid.load(std::memory_order_acquire);
+    while (attached != pid) {
+        if (process_alive(attached)) {
+            std::cerr << "ڴ " << name << " ж˽ " << attached << std::endl;
+            munmap(base, bytes);
+            return false;
+        }
+        if (header->reader_pid.compare_exchange_weak(attached, pid, std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+    base_ = base;
+    bytes_ = bytes;
+    header_ = header;
+    next_seq_ = header_->read_seq.load(std::memory_order_acquire);
+    return true;
+#endif
+}
+
+std::optional<ShmBatchView> ShmFrameRingReader::acquire(std::chrono::milliseconds timeout) {
+    if (header_ == nullptr) {
+        return std::nullopt;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (header_->write_seq.load(std::memory_order_acquire) <= next_seq_) {
+        if (header_->closed.load(std::memory_order_acquire) != 0 ||
+            std::chrono::steady_clock::now() >= deadline) {
+            return std::nullopt;
+        }
+        std::this_thread::sleep_for(kPollInterval);
+    }
+
+    unsigned char* slot = slot_base(header_, next_seq_);
+    auto* slot_header = reinterpret_cast<ShmSlotHeader*>(slot);
+    if (slot_header->state.load(std::memory_order_acquire) != shm_ring::kSlotReady ||
+        slot_header->seq.load(std::memory_order_relaxed) != next_seq_) {
+        std::cerr << "ڴλŲһ: " << next_seq_ << std::endl;
+        return std::nullopt;
+    }
+
+    ShmBatchView view;
+    view.seq = next_seq_;
+    view.batch.frame_index = static_cast<int>(slot_header->frame_index);
+    view.batch.timestamp = slot_header->timestamp;
+    const std::int32_t* cam_ids = slot_cam_ids(slot);
+    unsigned char* data = slot + header_->slot_header_bytes;
+    const int type = CV_8UC(static_cast<int>(header_->channels));
+    for (std::uint32_t i = 0; i < slot_header->cam_count; ++i) {
+        view.batch.frames.emplace(cam_ids[i], cv::Mat(static_cast<int>(header_->height),
+                                                      static_cast<int>(header_->width), type,
+                                                      data + i * header_->frame_stride));
+    }
+    ++next_seq_;
+    return view;
+}
+
+void ShmFrameRingReader::release(const ShmBatchView& view) {
+    if (header_ == nullptr) {
+        return;
+    }
+    auto* slot_header = reinterpret_cast<ShmSlotHeader*>(slot_base(header_, view.seq));
+    slot_header->state.store(shm_ring::kSlotEmpty, std::memory_order_release);
+    header_->read_seq.store(view.seq + 1, std::memory_order_release);
+}
+
+void ShmFrameRingReader::close() {
+#ifndef _WIN32
+    if (header_ != nullptr) {
+        // д˿ɾ֣ӳЧֻעԼĵǼ
+        auto pid = static_cast<std::uint32_t>(getpid());
+        header_->reader_pid.compare_exchange_strong(pid, 0, std::memory_order_acq_rel);
+    }
+    header_ = nullptr;
+    unmap(base_, bytes_);
+#endif
+}
@@ -0,0 +1,142 @@
+#include "sync_offsets.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <opencv2/core.hpp>
+
+namespace {
+// ȥֵ󿽱 dst ͷಿֱΪ 0ƽͣ
+double copy_centered(const std::vector<float>& src, cv::Mat& dst) {
+    double mean = 0.0;
+    for (const float value : src) {
+        mean += value;
+    }
+    mean /= static_cast<double>(src.size());
+    double energy = 0.0;
+    float* out = dst.ptr<float>();
+    for (std::size_t i = 0; i < src.size(); ++i) {
+        out[i] = static_cast<float>(src[i] - mean);
+        energy += static_cast<double>(out[i]) * out[i];
+    }
+    return energy;
+}
+} // namespace
+
+bool save_sync_offsets(const std::filesystem::path& path, const SyncOffsets& offsets) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "޷ļ: " << path << std::endl;
+        return false;
+    }
+    file << "cam_id,offset_ms,confidence\n";
+    for (const auto& [cam_id, offset] : offsets) {
+        file << cam_id << ',' << offset.offset_ms << ',' << offset.confidence << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+bool load_sync_offsets(const std::filesystem::path& path, SyncOffsets& offsets) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "޷ͬƫļ: " << path << std::endl;
+        return false;
+    }
+    offsets.clear();
+    std::string line;
+    std::getline(file, line); // ͷ
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::istringstream fields(line);
+        int cam_id = -1;
+        CameraOffset offset;
+        char comma = 0;
+        if (!(fields >> cam_id >> comma >> offset.offset_ms)) {
+            std::cerr << "ͬƫļʽ: " << line << std::endl;
+            return false;
+        }
+        fields >> comma >> offset.confidence; // Ŷȿʡ
+        offsets[cam_id] = offset;
+    }
+    return true;
+}
+
+std::map<int, double> offsets_in_ms(const SyncOffsets& offsets) {
+    std::map<int, double> result;
+    for (const auto& [cam_id, offset] : offsets) {
+        result[cam_id] = offset.offset_ms;
+    }
+    return result;
+}
+
+std::size_t choose_reference(const std::vector<int>& cam_ids, const std::vector<char>& usable,
+                             int reference_cam) {
+    for (std::size_t i = 0; i < cam_ids.size(); ++i) {
+        if (usable[i] && cam_ids[i] == reference_cam) {
+            return i;
+        }
+    }
+    for (std::size_t i = 0; i < cam_ids.size(); ++i) {
+        if (usable[i]) {
+            return i;
+        }
+    }
+    return cam_ids.size();
+}
+
+bool estimate_signal_lag(const std::vector<float>& reference, const std::vector<float>& signal,
+                         int max_lag, double& lag, double& confidence) {
+    if (reference.empty() || signal.empty()) {
+        return false;
+    }
+    // 㵽Ի賤ȣѭصĻ
+    const int length = static_cast<int>(reference.size() + signal.size()) - 1;
+    const int size = cv::getOptimalDFTSize(length);
+    cv::Mat ref_padded = cv::Mat::zeros(1, size, CV_32F);
+    cv::Mat sig_padded = cv::Mat::zeros(1, size, CV_32F);
+    const double energy = copy_centered(reference, ref_padded) * copy_centered(signal, sig_padded);
+    if (energy <= 0.0) {
+        return false;
+    }
+
+    // corr[k] = sum_n signal[n + k] * reference[n]ӳλĩβ
+    cv::Mat ref_spectrum;
+    cv::Mat sig_spectrum;
+    cv::Mat product;
+    cv::Mat corr;
+    cv::dft(ref_padded, ref_spectrum);
+    cv::dft(sig_padded, sig_spectrum);
+    cv::mulSpectrums(sig_spectrum, ref_spectrum, product, 0, true);
+    cv::dft(product, corr, cv::DFT_INVERSE | cv::DFT_REAL_OUTPUT | cv::DFT_SCALE);
+
+    const int max_positive = std::min(max_lag, static_cast<int>(signal.size()) - 1);
+    const int max_negative = std::min(max_lag, static_cast<int>(reference.size()) - 1);
+    const float* values = corr.ptr<float>();
+    auto at = [&](int k) { return values[k >= 0 ? k : size + k]; };
+    int best = 0;
+    for (int k = -max_negative; k <= max_positive; ++k) {
+        if (at(k) > at(best)) {
+            best = k;
+        }
+    }
+
+    // ֵֵ߲õ
+    lag = best;
+    if (best > -max_negative && best < max_positive) {
+        const double left = at(best - 1);
+        const double center = at(best);
+        const double right = at(best + 1);
+        const double denominator = left - 2.0 * center + right;
+        if (denominator < 0.0) {
+            lag += 0.5 * (left - right) / denominator;
+        }
+    }
+    confidence = std::clamp(at(best) / std::sqrt(energy), 0.0, 1.0);
+    return true;
+}
@@ -0,0 +1,146 @@
+#include "synthetic_video.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "sync_offsets.hpp"
+
+namespace {
+constexpr double kPanSpeed = 0.25; // ÿƽƵľ루ȵı
+constexpr double kFlashDuration = 0.1; // ʱ䣨룩
+constexpr double kFlashBoost = 120.0; // ʱ
+constexpr std::size_t kCorruptBytes = 64 * 1024; // ݵ󳤶ȣСļļС 1/4
+
+// ɫŴɵƽͼΪһƽټһλöܽس֡
+cv::Mat make_scene(const SyntheticVideoOptions& options, int period) {
+    cv::RNG rng(options.seed);
+    cv::Mat coarse(std::max(1, options.height / 16), std::max(1, period / 16), CV_8UC3);
+    rng.fill(coarse, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::Mat texture;
+    cv::resize(coarse, texture, cv::Size(period, options.height), 0, 0, cv::INTER_CUBIC);
+
+    cv::Mat scene(options.height, period + options.width, CV_8UC3);
+    cv::Mat head = scene.colRange(0, period);
+    texture.copyTo(head);
+    cv::Mat tail = scene.colRange(period, period + options.width);
+    texture.colRange(0, options.width).copyTo(tail);
+    return scene;
+}
+
+// GOP ֻͨ OpenCV  FFmpeg дˣ֮򿪵 VideoWriter Ч
+void set_writer_gop(int gop) {
+    if (gop <= 0) {
+        return;
+    }
+    const std::string value = "g;" + std::to_string(gop);
+#ifdef _WIN32
+    _putenv_s("OPENCV_FFMPEG_WRITER_OPTIONS", value.c_str());
+#else
+    setenv("OPENCV_FFMPEG_WRITER_OPTIONS", value.c_str(), 1);
+#endif
+}
+
+// ļвһֽڣļСţƵͷֱƵͬ
+bool corrupt_file(const std::filesystem::path& path, unsigned seed) {
+    const auto size = static_cast<std::size_t>(std::filesystem::file_size(path));
+    const std::size_t corrupt_bytes = std::min(kCorruptBytes, size / 4);
+    if (corrupt_bytes == 0) {
+        return false;
+    }
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    cv::RNG rng(seed);
+    std::vector<char> garbage(corrupt_bytes);
+    for (auto& byte : garbage) {
+        byte = static_cast<char>(rng() & 0xFF);
+    }
+    file.seekp(static_cast<std::streamoff>(size / 2));
+    file.write(garbage.data(), static_cast<std::streamsize>(garbage.size()));
+    return static_cast<bool>(file);
+}
+
+bool write_camera(const std::filesystem::path& path, int cam_id, const cv::Mat& scene, int period,
+                  const SyntheticVideoOptions& options) {
+    const double offset_s = [&]() {
+        const auto it = options.start_offsets_ms.find(cam_id);
+        return it != options.start_offsets_ms.end() ? it->second / 1000.0 : 0.0;
+    }();
+    double duration = options.duration_seconds;
+    if (options.short_cams.count(cam_id) != 0) {
+        duration *= options.short_fraction;
+    }
+    const int frames = std::max(1, static_cast<int>(std::lround(duration * options.fps)));
+
+    const std::string& code = options.fourcc;
+    const int fourcc = code.size() == 4 ? cv::VideoWriter::fourcc(code[0], code[1], code[2], code[3]) : 0;
+    cv::VideoWriter writer(path.string(), cv::CAP_FFMPEG, fourcc, options.fps,
+                           cv::Size(options.width, options.height), std::vector<int>{});
+    if (!writer.isOpened()) {
+        std::cerr << "޷Ƶ " << code << ": " << path << std::endl;
+        return false;
+    }
+
+    const double speed = kPanSpeed * options.width;
+    const int view_shift = cam_id * options.width / 8; // ӽǿĲͬ
+    cv::Mat frame;
+    for (int i = 0; i < frames; ++i) {
+        // Ƶʱ i/fps Ӧʱ i/fps - offset
+        const double scene_time = i / options.fps - offset_s;
+        const long position = static_cast<long>(std::floor(scene_time * speed)) + view_shift;
+        const int x = static_cast<int>(((position % period) + period) % period);
+        scene.colRange(x, x + options.width).copyTo(frame);
+        if (options.flash_at_seconds >= 0.0 && scene_time >= options.flash_at_seconds &&
+            scene_time < options.flash_at_seconds + kFlashDuration) {
+            frame.convertTo(frame, -1, 1.0, kFlashBoost);
+        }
+        // ¼ӽ볡ʱ䣬ۺ˶ͬ
+        std::ostringstream label;
+        label << "cam " << cam_id << "  t=" << std::fixed;
+        label.precision(3);
+        label << scene_time;
+        cv::putText(frame, label.str(), cv::Point(16, 40), cv::FONT_HERSHEY_SIMPLEX, 1.0,
+                    cv::Scalar(255, 255, 255), 2);
+        writer.write(frame);
+    }
+    writer.release();
+
+    if (options.corrupt_cams.count(cam_id) != 0 && !corrupt_file(path, options.seed + cam_id)) {
+        std::cerr << "޷д: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+bool generate_synthetic_videos(const std::filesystem::path& output_dir,
+                               const SyntheticVideoOptions& options) {
+    if (options.cameras <= 0 || options.width <= 0 || options.height <= 0 || options.fps <= 0.0) {
+        std::cerr << "ƵЧ" << std::endl;
+        return false;
+    }
+    set_writer_gop(options.gop);
+    const int period = options.width * 3;
+    const cv::Mat scene = make_scene(options, period);
+
+    SyncOffsets truth;
+    for (int cam_id = 0; cam_id < options.cameras; ++cam_id) {
+        const auto dir = output_dir / ("cam_" + std::to_string(cam_id));
+        std::filesystem::create_directories(dir);
+        if (!write_camera(dir / ("video" + options.extension), cam_id, scene, period, options)) {
+            return false;
+        }
+        const auto it = options.start_offsets_ms.find(cam_id);
+        truth[cam_id] = CameraOffset{it != options.start_offsets_ms.end() ? it->second : 0.0, 1.0};
+    }
+    return save_sync_offsets(output_dir / "ground_truth_offsets.csv", truth);
+}
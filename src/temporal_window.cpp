@@ -0,0 +1,60 @@
+#include "temporal_window.hpp"
+
+#include <algorithm>
+
+TemporalWindower::TemporalWindower(const WindowOptions& options) : options_(options) {
+    options_.length = std::max(1, options_.length);
+    options_.stride = std::max(1, options_.stride);
+}
+
+FrameWindow TemporalWindower::make_window() {
+    FrameWindow window;
+    window.window_index = next_window_++;
+    window.batches.assign(pending_.begin(), pending_.end());
+    fresh_ = 0;
+    return window;
+}
+
+std::optional<FrameWindow> TemporalWindower::push(FrameBatch batch) {
+    if (skip_ > 0) {
+        --skip_;
+        return std::nullopt;
+    }
+    pending_.push_back(std::make_shared<const FrameBatch>(std::move(batch)));
+    ++fresh_;
+    if (static_cast<int>(pending_.size()) < options_.length) {
+        return std::nullopt;
+    }
+
+    FrameWindow window = make_window();
+    // һ㣺ص֣ stride Ĳɺβ
+    const int drop = std::min(options_.stride, options_.length);
+    pending_.erase(pending_.begin(), pending_.begin() + drop);
+    skip_ = options_.stride - drop;
+    return window;
+}
+
+std::optional<FrameWindow> TemporalWindower::flush() {
+    if (!options_.emit_partial_tail || fresh_ == 0 || pending_.empty()) {
+        return std::nullopt;
+    }
+    FrameWindow window = make_window();
+    pending_.clear();
+    return window;
+}
+
+void window_frames(BlockingQueue<FrameBatch>& input, BlockingQueue<FrameWindow>& output,
+                   const WindowOptions& options) {
+    TemporalWindower windower(options);
+    while (auto batch = input.pop()) {
+        auto window = windower.push(std::move(*batch));
+        if (window && !output.push(std::move(*window))) {
+            input.close();
+            return;
+        }
+    }
+    if (auto tail = windower.flush()) {
+        output.push(std::move(*tail));
+    }
+    output.close();
+}
@@ -4,6 +4,10 @@
 #include <opencv2/opencv.hpp>
 #include <thread>
 
+#include "pipeline_metrics.hpp"
+#include "pipeline_trace.hpp"
+#include "progress_reporter.hpp"
+
 VideoTaskManager::VideoTaskManager(const std::vector<VideoReadTask>& tasks) {
     for (const auto& task : tasks) {
         task_queue_.push(task);
@@ -44,7 +48,8 @@ std::map<int, VideoReadTask> VideoTaskManager::get_completed_tasks() const {
     return completed_tasks_;
 }
 
-void video_read_thread(VideoTaskManager& task_manager) {
+void video_read_thread(VideoTaskManager& task_manager, const VideoSourceOptions& source_options) {
+    pipeline_tracer().name_thread("ingest");
     while (true) {
         auto opt_task = task_manager.get_task();
         if (!opt_task) {
@@ -52,16 +57,19 @@ void video_read_thread(VideoTaskManager& task_manager) {
         }
         auto task = *opt_task;
 
-        cv::VideoCapture cap(task.src);
-        if (!cap.isOpened()) {
+        // дҪ BGR ֡
+        VideoSourceOptions options = source_options;
+        options.native_yuv = false;
+        auto source = open_video_source(task.src, options);
+        if (!source) {
             task.is_failed = true;
             task_manager.finish_task(task);
             continue;
         }
 
-        double fps = cap.get(cv::CAP_PROP_FPS);
-        int width = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
-        int height = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+        double fps = source->fps();
+        int width = source->width();
+        int height = source->height();
         const cv::Size frame_size(width, height);
         const int preferred_fourcc = cv::VideoWriter::fourcc('H', '2', '6', '4');
         const int fallback_fourcc = cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
@@ -70,20 +78,48 @@ void video_read_thread(VideoTaskManager& task_manager) {
         if (!writer.isOpened()) {
             writer.open(task.save_path, fallback_fourcc, fps, frame_size, true);
             if (!writer.isOpened()) {
-                cap.release();
                 task.is_failed = true;
                 task_manager.finish_task(task);
                 continue;
             }
         }
 
+        StageMetrics* const decode_metrics = pipeline_metrics().stage("decode", task.cam_id);
+        StageMetrics* const encode_metrics = pipeline_metrics().stage("encode", task.cam_id);
+        ProgressCounter* const progress =
+            progress_reporter().add("ingest cam " + std::to_string(task.cam_id), source->frame_count());
+
+        // frame ߴ粻䣬ƵԴÿֱдͬһ黺
         cv::Mat frame;
-        while (cap.read(frame)) {
+        for (std::int64_t frame_index = 0;; ++frame_index) {
+            {
+                StageTimer timer(decode_metrics);
+                TraceSpan span("decode", task.cam_id, frame_index);
+                if (!source->read(frame)) {
+                    break;
+                }
+                timer.set_bytes(frame.total() * frame.elemSize());
+            }
+            StageTimer timer(encode_metrics);
+            TraceSpan span("encode", task.cam_id, frame_index);
+            timer.set_bytes(frame.total() * frame.elemSize());
             writer.write(frame);
+            if (progress) {
+                progress->add_frames(1, frame.total() * frame.elemSize());
+            }
         }
 
-        cap.release();
+        source.reset();
         writer.release();
+        if (progress) {
+            //ڲ壬дֻֽڹرպļСһ
+            std::error_code error;
+            const auto written = std::filesystem::file_size(task.save_path, error);
+            if (!error) {
+                progress->bytes_written = written;
+            }
+            progress->finish();
+        }
         task.is_completed = true;
         task_manager.finish_task(task);
     }
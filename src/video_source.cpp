@@ -0,0 +1,125 @@
+#include "video_source.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <vector>
+
+#include "file_access.hpp"
+
+namespace {
+// ȱŵָȺĳߴ
+cv::Size scaled_size(int width, int height, int output_width) {
+    if (output_width <= 0 || output_width >= width) {
+        return {width, height};
+    }
+    const int output_height = static_cast<int>(static_cast<double>(height) * output_width / width);
+    return {output_width, std::max(1, output_height)};
+}
+
+// cv::VideoCapture ˡ߳ͨ CAP_PROP_N_THREADS  FFmpeg ˣOpenCV 4.6+
+// VideoCapture ¶ļȡλãҳʾѽ֡ռ֡ıλ
+class OpenCvVideoSource : public VideoSource {
+public:
+    bool open(const std::filesystem::path& path, const VideoSourceOptions& options) {
+        if (options.readahead_bytes > 0 || options.drop_behind) {
+            hints_.open(path, options.readahead_bytes, options.drop_behind);
+        }
+        if (options.decoder_threads > 0) {
+            const std::vector<int> params = {cv::CAP_PROP_N_THREADS, options.decoder_threads};
+            cap_.open(path.string(), cv::CAP_ANY, params);
+        }
+        if (!cap_.isOpened() && !cap_.open(path.string())) {
+            return false;
+        }
+        fps_ = cap_.get(cv::CAP_PROP_FPS);
+        frame_count_ = static_cast<std::int64_t>(cap_.get(cv::CAP_PROP_FRAME_COUNT));
+        source_size_ = {static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_WIDTH)),
+                        static_cast<int>(cap_.get(cv::CAP_PROP_FRAME_HEIGHT))};
+        output_size_ = scaled_size(source_size_.width, source_size_.height, options.output_width);
+        return true;
+    }
+
+    bool read(cv::Mat& frame) override {
+        advance_hints();
+        if (output_size_ == source_size_) {
+            return cap_.read(frame);
+        }
+        // ȫֱ֡д˽лߴ粻ʱ·䣩ֻСĽ
+        if (!cap_.read(decode_buffer_)) {
+            return false;
+        }
+        cv::resize(decode_buffer_, frame, output_size_, 0, 0, cv::INTER_AREA);
+        return true;
+    }
+
+    bool grab() override {
+        advance_hints();
+        return cap_.grab();
+    }
+
+    std::int64_t seek(std::int64_t frame_index) override {
+        if (!cap_.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(frame_index))) {
+            return -1;
+        }
+        // CAP_PROP_POS_FRAMES ĶλںܶʽֻǽƣԲʵλΪ׼
+        const double position = cap_.get(cv::CAP_PROP_POS_FRAMES);
+        if (position < 0.0) {
+            return -1;
+        }
+        const auto landed = static_cast<std::int64_t>(std::llround(position));
+        position_frames_ = landed;
+        if (hints_.is_open() && frame_count_ > 0) {
+            hints_.reset(hints_.size() * static_cast<std::uint64_t>(landed) /
+                         static_cast<std::uint64_t>(frame_count_));
+        }
+        return landed;
+    }
+
+    double fps() const override { return fps_; }
+    int width() const override { return output_size_.width; }
+    int height() const override { return output_size_.height; }
+    std::int64_t frame_count() const override { return frame_count_; }
+    bool outputs_yuv() const override { return false; }
+    const char* backend_name() const override { return "opencv"; }
+
+private:
+    void advance_hints() {
+        const std::int64_t frame_index = position_frames_++;
+        if (hints_.is_open() && frame_count_ > 0) {
+            hints_.advance(hints_.size() * static_cast<std::uint64_t>(frame_index) /
+                           static_cast<std::uint64_t>(frame_count_));
+        }
+    }
+
+    cv::VideoCapture cap_; // Ƶ
+    FileAccessHints hints_; // ҳʾδʱ
+    std::int64_t position_frames_ = 0; // һν֡ţڹļȡλ
+    cv::Mat decode_buffer_; // ȫֱʽ뻺
+    cv::Size source_size_; // Դֱ
+    cv::Size output_size_; // ֱ
+    double fps_ = 0.0; // ֡
+    std::int64_t frame_count_ = 0; // ֡
+};
+} // namespace
+
+std::unique_ptr<VideoSource> open_video_source(const std::filesystem::path& path,
+                                               const VideoSourceOptions& options) {
+    if (options.backend == VideoBackend::LibAV) {
+#ifdef VGGT_WITH_LIBAV
+        return open_libav_source(path, options);
+#else
+        static std::once_flag warned;
+        std::call_once(warned, []() { std::cerr << "δ LibAV ˣ OpenCV " << std::endl; });
+#endif
+    }
+
+    auto source = std::make_unique<OpenCvVideoSource>();
+    if (!source->open(path, options)) {
+        return nullptr;
+    }
+    return source;
+}
@@ -0,0 +1,376 @@
+#include "video_source.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "file_access.hpp"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/mathematics.h>
+#include <libswscale/swscale.h>
+}
+
+namespace {
+//  AVIO ĴСȡҳÿζȡҳ
+// ַֻ av_malloc  SIMD 룺FFmpeg ̽ʽʱ av_free ·仺
+// ܻ posix_memalign ䷽ʽ
+constexpr std::size_t kPageBytes = 4096;
+
+// ֱӵ libavcodec ƵԴɿƽ̡߳lowres·˲ǲο֡
+// ԭ I420ɫת swscale һ
+class LibavVideoSource : public VideoSource {
+public:
+    ~LibavVideoSource() override {
+        sws_freeContext(sws_);
+        av_frame_free(&frame_);
+        av_packet_free(&packet_);
+        avcodec_free_context(&codec_);
+        avformat_close_input(&format_);
+        //  AVIO  avformat_close_input ͷ
+        if (avio_ != nullptr) {
+            av_freep(&avio_->buffer);
+            avio_context_free(&avio_);
+        }
+    }
+
+    bool open(const std::filesystem::path& path, const VideoSourceOptions& options) {
+        if (options.readahead_bytes > 0 || options.drop_behind || options.io_buffer_bytes > 0) {
+            hints_.open(path, options.readahead_bytes, options.drop_behind);
+        }
+        if (options.io_buffer_bytes > 0 && hints_.is_open() && !open_custom_io(options.io_buffer_bytes)) {
+            return false;
+        }
+        if (avformat_open_input(&format_, path.string().c_str(), nullptr, nullptr) < 0 ||
+            avformat_find_stream_info(format_, nullptr) < 0) {
+            return false;
+        }
+        const AVCodec* codec = nullptr;
+        stream_index_ = av_find_best_stream(format_, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+        if (stream_index_ < 0 || codec == nullptr) {
+            return false;
+        }
+        AVStream* stream = format_->streams[stream_index_];
+
+        codec_ = avcodec_alloc_context3(codec);
+        if (codec_ == nullptr || avcodec_parameters_to_context(codec_, stream->codecpar) < 0) {
+            return false;
+        }
+        codec_->thread_count = std::max(0, options.decoder_threads);
+        codec_->thread_type = (options.frame_threads ? FF_THREAD_FRAME : 0) |
+                              (options.slice_threads ? FF_THREAD_SLICE : 0);
+        if (options.skip_loop_filter) {
+            codec_->skip_loop_filter = AVDISCARD_ALL;
+        }
+        if (options.skip_nonref) {
+            codec_->skip_frame = AVDISCARD_NONREF;
+        }
+        // lowres ַ֧Χʱ avcodec_open2 ضϣH.264/HEVC ֧֣Ϊ 0
+        AVDictionary* codec_options = nullptr;
+        if (options.lowres > 0) {
+            av_dict_set_int(&codec_options, "lowres", options.lowres, 0);
+        }
+        const int ret = avcodec_open2(codec_, codec, &codec_options);
+        av_dict_free(&codec_options);
+        if (ret < 0) {
+            return false;
+        }
+
+        packet_ = av_packet_alloc();
+        frame_ = av_frame_alloc();
+        if (packet_ == nullptr || frame_ == nullptr) {
+            return false;
+        }
+
+        const AVRational rate =
+            stream->avg_frame_rate.num > 0 ? stream->avg_frame_rate : stream->r_frame_rate;
+        fps_ = rate.num > 0 && rate.den > 0 ? av_q2d(rate) : 0.0;
+        frame_rate_ = rate;
+        time_base_ = stream->time_base;
+        start_pts_ = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        frame_count_ = stream->nb_frames;
+        if (frame_count_ <= 0 && format_->duration > 0 && fps_ > 0.0) {
+            frame_count_ = static_cast<std::int64_t>(format_->duration * fps_ / AV_TIME_BASE);
+        }
+
+        // lowres ЧߴСﰴʵߴ
+        decoded_width_ = codec_->width;
+        decoded_height_ = codec_->height;
+        native_yuv_ = options.native_yuv;
+        requested_width_ = options.output_width;
+        update_output_size();
+        return true;
+    }
+
+    bool grab() override { return decode_next(); }
+
+    // ֡ʻΪʱseek ֮ǰĹؼ֡벢Ŀ֮ǰ֡
+    // ص֡ɽʱ㣬ûʱ֡޷ȷ֡ţһ
+    std::int64_t seek(std::int64_t frame_index) override {
+        if (frame_rate_.num <= 0 || frame_rate_.den <= 0) {
+            return -1;
+        }
+        const std::int64_t target =
+            start_pts_ + av_rescale_q(frame_index, av_inv_q(frame_rate_), time_base_);
+        if (av_seek_frame(format_, stream_index_, target, AVSEEK_FLAG_BACKWARD) < 0) {
+            return -1;
+        }
+        hints_.reset(static_cast<std::uint64_t>(std::max<std::int64_t>(0, avio_tell(format_->pb))));
+        avcodec_flush_buffers(codec_);
+        draining_ = false;
+        pending_ = false;
+        while (decode_next()) {
+            const std::int64_t pts = frame_->best_effort_timestamp;
+            if (pts == AV_NOPTS_VALUE) {
+                continue;
+            }
+            const std::int64_t landed = av_rescale_q(pts - start_pts_, time_base_, av_inv_q(frame_rate_));
+            if (landed >= frame_index) {
+                // ѽĿ֡һ read/grab
+                pending_ = true;
+                return landed;
+            }
+        }
+        return -1;
+    }
+
+    bool read(cv::Mat& frame) override {
+        if (!decode_next()) {
+            return false;
+        }
+        if (frame_->width != decoded_width_ || frame_->height != decoded_height_) {
+            decoded_width_ = frame_->width;
+            decoded_height_ = frame_->height;
+            update_output_size();
+        }
+        const auto format = static_cast<AVPixelFormat>(frame_->format);
+        // ֻ޷ΧMPEG YUV420P ֱӿȫΧYUVJ420P  color_range Ϊ JPEG
+        //  swscale ѹ޷Χΰ޷Χϵת BGR ƫɫԱȶʧ
+        const bool limited_yuv420 =
+            format == AV_PIX_FMT_YUV420P && frame_->color_range != AVCOL_RANGE_JPEG;
+        if (native_yuv_ && limited_yuv420 && output_width_ == decoded_width_) {
+            copy_i420(frame);
+            return true;
+        }
+        return convert(frame, format);
+    }
+
+    double fps() const override { return fps_; }
+    int width() const override { return output_width_; }
+    int height() const override { return output_height_; }
+    std::int64_t frame_count() const override { return frame_count_; }
+    bool outputs_yuv() const override { return native_yuv_; }
+    const char* backend_name() const override { return "libav"; }
+
+private:
+    // ļ黺 FFmpeg Ĭϵ 32KB ȡ
+    // ˳ʾÿ read ϵͳö
+    bool open_custom_io(std::size_t buffer_bytes) {
+#ifdef _WIN32
+        (void)buffer_bytes;
+        return true;
+#else
+        const std::size_t size = (buffer_bytes + kPageBytes - 1) / kPageBytes * kPageBytes;
+        auto* buffer = static_cast<unsigned char*>(av_malloc(size));
+        if (buffer == nullptr) {
+            return false;
+        }
+        avio_ = avio_alloc_context(buffer, static_cast<int>(size), 0, this, &LibavVideoSource::read_file,
+                                   nullptr, &LibavVideoSource::seek_file);
+        if (avio_ == nullptr) {
+            av_free(buffer);
+            return false;
+        }
+        format_ = avformat_alloc_context();
+        if (format_ == nullptr) {
+            return false;
+        }
+        format_->pb = avio_;
+        format_->flags |= AVFMT_FLAG_CUSTOM_IO;
+        return true;
+#endif
+    }
+
+#ifndef _WIN32
+    static int read_file(void* opaque, uint8_t* buffer, int size) {
+        auto* self = static_cast<LibavVideoSource*>(opaque);
+        const ssize_t n = pread(self->hints_.fd(), buffer, static_cast<std::size_t>(size),
+                                static_cast<off_t>(self->io_offset_));
+        if (n < 0) {
+            return AVERROR(errno);
+        }
+        if (n == 0) {
+            return AVERROR_EOF;
+        }
+        self->io_offset_ += static_cast<std::uint64_t>(n);
+        return static_cast<int>(n);
+    }
+
+    static int64_t seek_file(void* opaque, int64_t offset, int whence) {
+        auto* self = static_cast<LibavVideoSource*>(opaque);
+        const auto size = static_cast<int64_t>(self->hints_.size());
+        switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return size;
+        case SEEK_SET:
+            break;
+        case SEEK_CUR:
+            offset += static_cast<int64_t>(self->io_offset_);
+            break;
+        case SEEK_END:
+            offset += size;
+            break;
+        default:
+            return AVERROR(EINVAL);
+        }
+        if (offset < 0) {
+            return AVERROR(EINVAL);
+        }
+        self->io_offset_ = static_cast<std::uint64_t>(offset);
+        return offset;
+    }
+#endif
+
+    void update_output_size() {
+        const int requested = requested_width_ > 0 ? requested_width_ : decoded_width_;
+        output_width_ = std::min(requested, decoded_width_);
+        output_height_ = std::max(1, static_cast<int>(static_cast<double>(decoded_height_) *
+                                                      output_width_ / std::max(1, decoded_width_)));
+        if (native_yuv_) {
+            // I420 ɫƽȵһ룬Ϊż
+            output_width_ &= ~1;
+            output_height_ &= ~1;
+        }
+    }
+
+    // ݰֱ³һ֡ļˢеʣ֡
+    bool decode_next() {
+        if (pending_) {
+            pending_ = false;
+            return true;
+        }
+        while (true) {
+            const int ret = avcodec_receive_frame(codec_, frame_);
+            if (ret == 0) {
+                return true;
+            }
+            if (ret != AVERROR(EAGAIN) || draining_) {
+                return false;
+            }
+            if (av_read_frame(format_, packet_) < 0) {
+                avcodec_send_packet(codec_, nullptr);
+                draining_ = true;
+                continue;
+            }
+            hints_.advance(static_cast<std::uint64_t>(std::max<std::int64_t>(0, avio_tell(format_->pb))));
+            if (packet_->stream_index == stream_index_) {
+                // 𻵵ݰɽлָһɽ֡
+                avcodec_send_packet(codec_, packet_);
+            }
+            av_packet_unref(packet_);
+        }
+    }
+
+    // ԭ I420ƽ水 cv::COLOR_YUV2BGR_I420 ԼĽղֿ
+    void copy_i420(cv::Mat& frame) {
+        const int w = output_width_;
+        const int h = output_height_;
+        frame.create(h * 3 / 2, w, CV_8UC1);
+        unsigned char* dst = frame.data;
+        for (int y = 0; y < h; ++y, dst += w) {
+            std::memcpy(dst, frame_->data[0] + y * frame_->linesize[0], w);
+        }
+        for (int plane = 1; plane <= 2; ++plane) {
+            for (int y = 0; y < h / 2; ++y, dst += w / 2) {
+                std::memcpy(dst, frame_->data[plane] + y * frame_->linesize[plane], w / 2);
+            }
+        }
+    }
+
+    // ɫת swscale һɣֱд Mat
+    bool convert(cv::Mat& frame, AVPixelFormat format) {
+        const AVPixelFormat dst_format = native_yuv_ ? AV_PIX_FMT_YUV420P : AV_PIX_FMT_BGR24;
+        sws_ = sws_getCachedContext(sws_, frame_->width, frame_->height, format, output_width_,
+                                    output_height_, dst_format, SWS_AREA, nullptr, nullptr, nullptr);
+        if (sws_ == nullptr) {
+            return false;
+        }
+        set_source_range();
+        uint8_t* dst_data[4] = {};
+        int dst_linesize[4] = {};
+        if (native_yuv_) {
+            frame.create(output_height_ * 3 / 2, output_width_, CV_8UC1);
+            av_image_fill_arrays(dst_data, dst_linesize, frame.data, AV_PIX_FMT_YUV420P, output_width_,
+                                 output_height_, 1);
+        } else {
+            frame.create(output_height_, output_width_, CV_8UC3);
+            dst_data[0] = frame.data;
+            dst_linesize[0] = static_cast<int>(frame.step[0]);
+        }
+        sws_scale(sws_, frame_->data, frame_->linesize, 0, frame_->height, dst_data, dst_linesize);
+        return true;
+    }
+
+    // YUVJ ʽ swscale ԶȫΧͨ YUV ʽ color_range ȫΧ
+    // ʽ swscaleûؽתֻ뵱ǰòͬʱ
+    void set_source_range() {
+        int* inv_table = nullptr;
+        int* table = nullptr;
+        int src_range = 0;
+        int dst_range = 0;
+        int brightness = 0;
+        int contrast = 0;
+        int saturation = 0;
+        if (sws_getColorspaceDetails(sws_, &inv_table, &src_range, &table, &dst_range, &brightness,
+                                     &contrast, &saturation) < 0) {
+            return; // RGB ȷ YUV ûзΧ
+        }
+        const int full_range = frame_->color_range == AVCOL_RANGE_JPEG ? 1 : src_range;
+        if (full_range != src_range) {
+            sws_setColorspaceDetails(sws_, inv_table, full_range, table, dst_range, brightness,
+                                     contrast, saturation);
+        }
+    }
+
+    AVFormatContext* format_ = nullptr; // װʽ
+    AVIOContext* avio_ = nullptr; //  AVIOio_buffer_bytes > 0 ʱ FFmpeg ļ
+    FileAccessHints hints_; // ҳʾ AVIO ʹõļ
+    std::uint64_t io_offset_ = 0; //  AVIO ļȡλ
+    AVCodecContext* codec_ = nullptr; // 
+    AVPacket* packet_ = nullptr; // õݰ
+    AVFrame* frame_ = nullptr; // õĽ֡
+    SwsContext* sws_ = nullptr; // ɫת/
+    int stream_index_ = -1; // Ƶ
+    bool draining_ = false; // ѽˢ׶
+    bool pending_ = false; // seek ѽ롢δ֡
+    AVRational frame_rate_{0, 1}; // ֡ʣ֡ʱ
+    AVRational time_base_{0, 1}; // Ƶʱ
+    std::int64_t start_pts_ = 0; // Ƶʼʱ
+    bool native_yuv_ = false; //  I420
+    double fps_ = 0.0; // ֡
+    std::int64_t frame_count_ = 0; // ֡
+    int requested_width_ = 0; // ȣ0 ʾһ
+    int decoded_width_ = 0; // 
+    int decoded_height_ = 0; // ߶
+    int output_width_ = 0; // 
+    int output_height_ = 0; // ߶
+};
+} // namespace
+
+std::unique_ptr<VideoSource> open_libav_source(const std::filesystem::path& path,
+                                               const VideoSourceOptions& options) {
+    auto source = std::make_unique<LibavVideoSource>();
+    if (!source->open(path, options)) {
+        std::cerr << "LibAV ޷Ƶ: " << path << std::endl;
+        return nullptr;
+    }
+    return source;
+}